@@ -0,0 +1,986 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2024 Ahmet Burak Irmak (https://youtube.com/Microesque)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Library GitHub Page:   https://github.com/Microesque/SSD1306
+ * Library Documentation: https://github.com/Microesque/SSD1306/wiki
+ */
+
+/**
+ * Host benchmark of the draw and buffer functions.
+ *
+ * Usage: ssd1306_bench [--smoke] [-o FILE]
+ *
+ *  --smoke  Runs every case once on a few inputs and checks the display
+ *           contents with the emulator (for ctest). Timings are meaningless.
+ *  -o FILE  Also writes the report to FILE.
+ *
+ * Each function is timed over a set of randomized inputs (partly out of
+ * bounds) and a set of worst-case inputs (large/full screen shapes, far out of
+ * bounds endpoints). ns/pixel divides the time by the number of pixels the
+ * inputs turn on (the whole buffer for the buffer and update functions). The
+ * update functions include the emulator on the other end of the transport.
+ * The reference cases draw the same shapes the way the library did before it
+ * was optimized, so the speedups can be reproduced.
+ */
+
+/*----------------------------------------------------------------------------*/
+/*---------------------------- Necessary Libraries ---------------------------*/
+/*----------------------------------------------------------------------------*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../emulator/ssd1306_emulator.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------- Bench Setup --------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+#define BENCH_INPUT_COUNT 256       /* Inputs per case */
+#define BENCH_SMOKE_INPUT_COUNT 8   /* Inputs per case with --smoke */
+#define BENCH_MIN_TIME_NS 20000000u /* Minimum measuring time per case */
+
+#define BENCH_FONT_FIRST 0x20
+#define BENCH_FONT_LAST 0x7E
+#define BENCH_FONT_GLYPHS (BENCH_FONT_LAST - BENCH_FONT_FIRST + 1)
+#define BENCH_GLYPH_BYTES 5 /* 5x7 pixels, bit-packed */
+
+static const char BENCH_TEXT[] =
+    "The quick brown fox jumps over the lazy dog. 0123456789 "
+    "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG!";
+
+/*
+ * Inputs of a single call, meaning depends on the case.
+ */
+struct bench_input {
+    int16_t v[16];
+};
+
+/*
+ * A benchmarked function.
+ */
+struct bench_case {
+    const char *name;
+    void (*generate)(struct bench_input *input, int16_t height, bool is_worst,
+                     int16_t param);
+    void (*run)(struct ssd1306_display *display,
+                const struct bench_input *input);
+    int16_t param;
+    bool is_whole_buffer;
+};
+
+/*----------------------------------------------------------------------------*/
+/*--------------------------------- Resources --------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+static uint32_t bench_random_state;
+static uint8_t bench_bitmap[128 * 64 / 8];
+static uint8_t bench_font_bitmap[BENCH_FONT_GLYPHS * BENCH_GLYPH_BYTES];
+static struct ssd1306_glyph bench_font_glyphs[BENCH_FONT_GLYPHS];
+static const struct ssd1306_font bench_font = {
+    bench_font_bitmap, bench_font_glyphs, BENCH_FONT_FIRST, BENCH_FONT_LAST, 8};
+static const uint8_t bench_custom_char_bitmap[] = {0x3C, 0x42, 0xA5, 0x81,
+                                                   0xA5, 0x99, 0x42, 0x3C};
+static const struct ssd1306_custom_char bench_custom_char = {
+    bench_custom_char_bitmap, 8, 8, 0, -8, 9};
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------- Helper Functions -----------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Returns a pseudo-random number (xorshift32), the sequence is the same
+ * on every run.
+ */
+static uint32_t h_random(void) {
+    uint32_t x = bench_random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    bench_random_state = x;
+    return x;
+}
+
+/**
+ * @brief Returns a pseudo-random number in the range [min, max].
+ */
+static int16_t h_random_range(int16_t min, int16_t max) {
+    return (int16_t)(min + (int16_t)(h_random() % (uint32_t)(max - min + 1)));
+}
+
+/**
+ * @brief Returns the monotonic time in nanoseconds.
+ */
+static uint64_t h_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Fills the bitmap and the synthetic 5x7 font used by the bitmap and
+ * text cases. The glyphs are noise; only the timing matters.
+ */
+static void h_setup_resources(void) {
+    bench_random_state = 0x12345678;
+    for (size_t i = 0; i < sizeof(bench_bitmap); i++)
+        bench_bitmap[i] = (uint8_t)h_random();
+    for (size_t i = 0; i < sizeof(bench_font_bitmap); i++)
+        bench_font_bitmap[i] = (uint8_t)h_random();
+    for (uint16_t i = 0; i < BENCH_FONT_GLYPHS; i++) {
+        bench_font_glyphs[i].bitmap_offset = i * BENCH_GLYPH_BYTES;
+        bench_font_glyphs[i].width = 5;
+        bench_font_glyphs[i].height = 7;
+        bench_font_glyphs[i].x_advance = 6;
+        bench_font_glyphs[i].x_offset = 0;
+        bench_font_glyphs[i].y_offset = -7;
+    }
+}
+
+/**
+ * @brief Returns the number of pixels that are on in the buffer.
+ */
+static uint32_t h_count_pixels(struct ssd1306_display *display) {
+    const uint8_t *buffer = sd1306_get_buffer(display) + 2;
+    uint16_t size = 512;
+    if (ssd1306_get_display_type(display))
+        size = 1024;
+
+    uint32_t count = 0;
+    for (uint16_t i = 0; i < size; i++) {
+        uint8_t byte = buffer[i];
+        while (byte) {
+            byte &= (uint8_t)(byte - 1);
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Draws a line pixel by pixel with Bresenham's algorithm, the way
+ * ssd1306_draw_line() did before it rasterized runs. Draws the same pixels,
+ * it's the reference the line cases are compared against.
+ */
+static void h_draw_line_reference(struct ssd1306_display *display, int16_t x0,
+                                  int16_t y0, int16_t x1, int16_t y1) {
+    int16_t dx = (int16_t)abs(x1 - x0);
+    int16_t dy = (int16_t)abs(y1 - y0);
+    bool is_swapped = (dy > dx);
+    if (is_swapped) {
+        int16_t temp = x0;
+        x0 = y0;
+        y0 = temp;
+        temp = x1;
+        x1 = y1;
+        y1 = temp;
+    }
+    if (x0 > x1) {
+        int16_t temp = x0;
+        x0 = x1;
+        x1 = temp;
+        temp = y0;
+        y0 = y1;
+        y1 = temp;
+    }
+
+    dx = x1 - x0;
+    dy = y1 - y0;
+    int16_t yi = 1;
+    if (dy < 0) {
+        yi = -1;
+        dy = -dy;
+    }
+    int16_t d = -(int16_t)((uint16_t)dx >> 1);
+    for (; x0 <= x1; x0++) {
+        if (is_swapped)
+            ssd1306_draw_pixel(display, y0, x0);
+        else
+            ssd1306_draw_pixel(display, x0, y0);
+        d += dy;
+        if (d > 0) {
+            d -= dx;
+            y0 += yi;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/*-------------------------------- Generators --------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Random inputs reach 16 pixels outside the screen so that clipping is part of
+ * the measurement. Worst-case inputs cover the whole screen, or come from far
+ * outside of it.
+ */
+
+static void g_none(struct bench_input *input, int16_t height, bool is_worst,
+                   int16_t param) {
+    (void)input;
+    (void)height;
+    (void)is_worst;
+    (void)param;
+}
+
+static void g_count(struct bench_input *input, int16_t height, bool is_worst,
+                    int16_t param) {
+    (void)height;
+    (void)is_worst;
+    input->v[0] = param;
+}
+
+static void g_pane(struct bench_input *input, int16_t height, bool is_worst,
+                   int16_t param) {
+    (void)is_worst;
+    input->v[0] = 44;
+    input->v[1] = 0;
+    input->v[2] = 83;
+    input->v[3] = height - 1;
+    input->v[4] = param;
+}
+
+static void g_point(struct bench_input *input, int16_t height, bool is_worst,
+                    int16_t param) {
+    (void)param;
+    if (is_worst) {
+        input->v[0] = h_random_range(0, 127);
+        input->v[1] = h_random_range(0, height - 1);
+    } else {
+        input->v[0] = h_random_range(-16, 143);
+        input->v[1] = h_random_range(-16, height + 15);
+    }
+}
+
+static void g_line_hv(struct bench_input *input, int16_t height, bool is_worst,
+                      int16_t param) {
+    g_point(input, height, false, param);
+    if (is_worst) {
+        /* Full width/height, starting from the opposite side */
+        input->v[0] = 127;
+        input->v[1] = height - 1;
+        input->v[2] = -128;
+        input->v[3] = -height;
+    } else {
+        input->v[2] = h_random_range(-140, 140);
+        input->v[3] = h_random_range(-(height + 12), height + 12);
+    }
+}
+
+static void g_two_points(struct bench_input *input, int16_t height,
+                         bool is_worst, int16_t param) {
+    if (param) {
+        /* Long shallow (1) or steep (2) lines, like plot axes and traces */
+        int16_t skew = is_worst ? 1 : h_random_range(-4, 4);
+        int16_t along_max = (param == 1) ? 127 : height - 1;
+        int16_t across_max = (param == 1) ? height - 1 : 127;
+        int16_t a0 = is_worst ? 0 : h_random_range(0, along_max / 4);
+        int16_t a1 = is_worst ? along_max
+                              : h_random_range(along_max - along_max / 4,
+                                               along_max);
+        int16_t b0 = h_random_range(4, across_max - 4);
+        input->v[(param == 1) ? 0 : 1] = a0;
+        input->v[(param == 1) ? 1 : 0] = b0;
+        input->v[(param == 1) ? 2 : 3] = a1;
+        input->v[(param == 1) ? 3 : 2] = b0 + skew;
+    } else if (is_worst) {
+        /* Crosses the screen, with both ends far outside */
+        int16_t dx = h_random_range(-2000, 2000);
+        int16_t dy = h_random_range(-2000, 2000);
+        input->v[0] = 64 + dx;
+        input->v[1] = (height / 2) + dy;
+        input->v[2] = 64 - dx;
+        input->v[3] = (height / 2) - dy;
+    } else {
+        input->v[0] = h_random_range(-16, 143);
+        input->v[1] = h_random_range(-16, height + 15);
+        input->v[2] = h_random_range(-16, 143);
+        input->v[3] = h_random_range(-16, height + 15);
+    }
+}
+
+static void g_triangle(struct bench_input *input, int16_t height, bool is_worst,
+                       int16_t param) {
+    (void)param;
+    if (is_worst) {
+        /* Covers most of the screen, two edges cross it */
+        input->v[0] = -20;
+        input->v[1] = -20;
+        input->v[2] = 147;
+        input->v[3] = height / 2;
+        input->v[4] = -20;
+        input->v[5] = height + 19;
+        return;
+    }
+    for (uint8_t i = 0; i < 6; i += 2) {
+        input->v[i] = h_random_range(-16, 143);
+        input->v[i + 1] = h_random_range(-16, height + 15);
+    }
+}
+
+static void g_polygon(struct bench_input *input, int16_t height, bool is_worst,
+                      int16_t param) {
+    /* Octagon with a random radius per vertex (gauge needles, stars, etc.).
+     * The worst case covers the screen, or just fits on it (param 1) so that
+     * the outline is visible */
+    static const int8_t unit[8][2] = {{100, 0},  {71, 71},   {0, 100},
+                                      {-71, 71}, {-100, 0},  {-71, -71},
+                                      {0, -100}, {71, -71}};
+    int16_t x0 = 64, y0 = height / 2, r = 100;
+    if (param)
+        r = (height / 2) - 1;
+    if (!is_worst) {
+        x0 = h_random_range(-16, 143);
+        y0 = h_random_range(-16, height + 15);
+        r = h_random_range(4, 60);
+    }
+    for (uint8_t i = 0; i < 8; i++) {
+        int16_t r_vertex = is_worst ? r : h_random_range(r / 2, r);
+        input->v[i << 1] = x0 + (unit[i][0] * r_vertex) / 100;
+        input->v[(i << 1) + 1] = y0 + (unit[i][1] * r_vertex) / 100;
+    }
+}
+
+static void g_rect(struct bench_input *input, int16_t height, bool is_worst,
+                   int16_t param) {
+    (void)param;
+    if (is_worst) {
+        input->v[0] = 0;
+        input->v[1] = 0;
+        input->v[2] = 128;
+        input->v[3] = height;
+        input->v[4] = height / 4;
+        return;
+    }
+    input->v[0] = h_random_range(-16, 127);
+    input->v[1] = h_random_range(-16, height - 1);
+    input->v[2] = h_random_range(1, 100);
+    input->v[3] = h_random_range(1, height);
+    input->v[4] = h_random_range(0, 16);
+}
+
+static void g_circle(struct bench_input *input, int16_t height, bool is_worst,
+                     int16_t param) {
+    (void)param;
+    if (is_worst) {
+        /* Centered, taller than the screen */
+        input->v[0] = 64;
+        input->v[1] = height / 2;
+        input->v[2] = height - 1;
+        input->v[3] = 0x0F;
+        return;
+    }
+    input->v[0] = h_random_range(-16, 143);
+    input->v[1] = h_random_range(-16, height + 15);
+    input->v[2] = h_random_range(0, 40);
+    input->v[3] = h_random_range(1, 15);
+}
+
+static void g_bitmap(struct bench_input *input, int16_t height, bool is_worst,
+                     int16_t param) {
+    input->v[4] = param;
+    if (is_worst) {
+        input->v[0] = 0;
+        input->v[1] = 0;
+        input->v[2] = 128;
+        input->v[3] = height;
+        return;
+    }
+    input->v[0] = h_random_range(-16, 127);
+    input->v[1] = h_random_range(-16, height - 1);
+    input->v[2] = 32;
+    input->v[3] = 32;
+}
+
+static void g_text(struct bench_input *input, int16_t height, bool is_worst,
+                   int16_t param) {
+    if (is_worst) {
+        /* The whole text, wrapping from the top left corner */
+        input->v[0] = 0;
+        input->v[1] = 8 * param;
+    } else {
+        input->v[0] = h_random_range(0, 100);
+        input->v[1] = h_random_range(0, height + 8);
+    }
+    input->v[2] = param;
+}
+
+/*----------------------------------------------------------------------------*/
+/*---------------------------------- Runners ---------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+static void r_clear(struct ssd1306_display *display,
+                    const struct bench_input *input) {
+    (void)input;
+    ssd1306_draw_clear(display);
+}
+
+static void r_fill(struct ssd1306_display *display,
+                   const struct bench_input *input) {
+    (void)input;
+    ssd1306_draw_fill(display);
+}
+
+static void r_invert(struct ssd1306_display *display,
+                     const struct bench_input *input) {
+    (void)input;
+    ssd1306_draw_invert(display);
+}
+
+static void r_mirror_h(struct ssd1306_display *display,
+                       const struct bench_input *input) {
+    (void)input;
+    ssd1306_draw_mirror_h(display);
+}
+
+static void r_mirror_v(struct ssd1306_display *display,
+                       const struct bench_input *input) {
+    (void)input;
+    ssd1306_draw_mirror_v(display);
+}
+
+static void r_shift_right(struct ssd1306_display *display,
+                          const struct bench_input *input) {
+    (void)input;
+    ssd1306_draw_shift_right(display, true);
+}
+
+static void r_shift_left(struct ssd1306_display *display,
+                         const struct bench_input *input) {
+    (void)input;
+    ssd1306_draw_shift_left(display, true);
+}
+
+static void r_shift_up(struct ssd1306_display *display,
+                       const struct bench_input *input) {
+    (void)input;
+    ssd1306_draw_shift_up(display, true);
+}
+
+static void r_shift_up_plain(struct ssd1306_display *display,
+                             const struct bench_input *input) {
+    (void)input;
+    ssd1306_draw_shift_up(display, false);
+}
+
+static void r_shift_down(struct ssd1306_display *display,
+                         const struct bench_input *input) {
+    (void)input;
+    ssd1306_draw_shift_down(display, true);
+}
+
+static void r_shift_right_by(struct ssd1306_display *display,
+                             const struct bench_input *input) {
+    ssd1306_draw_shift_right_by(display, (uint8_t)input->v[0], true);
+}
+
+static void r_shift_left_by(struct ssd1306_display *display,
+                            const struct bench_input *input) {
+    ssd1306_draw_shift_left_by(display, (uint8_t)input->v[0], true);
+}
+
+static void r_shift_up_by(struct ssd1306_display *display,
+                          const struct bench_input *input) {
+    ssd1306_draw_shift_up_by(display, (uint8_t)input->v[0], true);
+}
+
+static void r_shift_down_by(struct ssd1306_display *display,
+                            const struct bench_input *input) {
+    ssd1306_draw_shift_down_by(display, (uint8_t)input->v[0], true);
+}
+
+static void r_pane_invert(struct ssd1306_display *display,
+                          const struct bench_input *input) {
+    ssd1306_set_draw_border(display, (uint8_t)input->v[0], (uint8_t)input->v[1],
+                            (uint8_t)input->v[2], (uint8_t)input->v[3]);
+    ssd1306_set_transform_mode(display, SSD1306_TRANSFORM_MODE_BORDER);
+    ssd1306_draw_invert(display);
+}
+
+static void r_pane_shift_up_by(struct ssd1306_display *display,
+                               const struct bench_input *input) {
+    ssd1306_set_draw_border(display, (uint8_t)input->v[0], (uint8_t)input->v[1],
+                            (uint8_t)input->v[2], (uint8_t)input->v[3]);
+    ssd1306_set_transform_mode(display, SSD1306_TRANSFORM_MODE_BORDER);
+    ssd1306_draw_shift_up_by(display, (uint8_t)input->v[4], false);
+}
+
+static void r_pixel(struct ssd1306_display *display,
+                    const struct bench_input *input) {
+    ssd1306_draw_pixel(display, input->v[0], input->v[1]);
+}
+
+static void r_line_h(struct ssd1306_display *display,
+                     const struct bench_input *input) {
+    ssd1306_draw_line_h(display, input->v[0], input->v[1], input->v[2]);
+}
+
+static void r_line_v(struct ssd1306_display *display,
+                     const struct bench_input *input) {
+    ssd1306_draw_line_v(display, input->v[0], input->v[1], input->v[3]);
+}
+
+static void r_line(struct ssd1306_display *display,
+                   const struct bench_input *input) {
+    ssd1306_draw_line(display, input->v[0], input->v[1], input->v[2],
+                      input->v[3]);
+}
+
+static void r_line_reference(struct ssd1306_display *display,
+                             const struct bench_input *input) {
+    h_draw_line_reference(display, input->v[0], input->v[1], input->v[2],
+                          input->v[3]);
+}
+
+static void r_triangle(struct ssd1306_display *display,
+                       const struct bench_input *input) {
+    ssd1306_draw_triangle(display, input->v[0], input->v[1], input->v[2],
+                          input->v[3], input->v[4], input->v[5]);
+}
+
+static void r_triangle_fill(struct ssd1306_display *display,
+                            const struct bench_input *input) {
+    ssd1306_draw_triangle_fill(display, input->v[0], input->v[1], input->v[2],
+                               input->v[3], input->v[4], input->v[5]);
+}
+
+static void r_polygon(struct ssd1306_display *display,
+                      const struct bench_input *input) {
+    ssd1306_draw_polygon(display, input->v, 8);
+}
+
+static void r_polygon_fill(struct ssd1306_display *display,
+                           const struct bench_input *input) {
+    ssd1306_draw_polygon_fill(display, input->v, 8, SSD1306_FILL_RULE_NON_ZERO);
+}
+
+static void r_polygon_fan(struct ssd1306_display *display,
+                          const struct bench_input *input) {
+    /* The same octagon, as triangles around the first vertex */
+    for (uint8_t i = 2; i < 14; i += 2)
+        ssd1306_draw_triangle_fill(display, input->v[0], input->v[1],
+                                   input->v[i], input->v[i + 1],
+                                   input->v[i + 2], input->v[i + 3]);
+}
+
+static void r_rect(struct ssd1306_display *display,
+                   const struct bench_input *input) {
+    ssd1306_draw_rect(display, input->v[0], input->v[1], input->v[2],
+                      input->v[3]);
+}
+
+static void r_rect_fill(struct ssd1306_display *display,
+                        const struct bench_input *input) {
+    ssd1306_draw_rect_fill(display, input->v[0], input->v[1], input->v[2],
+                           input->v[3]);
+}
+
+static void r_rect_round(struct ssd1306_display *display,
+                         const struct bench_input *input) {
+    ssd1306_draw_rect_round(display, input->v[0], input->v[1], input->v[2],
+                            input->v[3], input->v[4]);
+}
+
+static void r_rect_round_fill(struct ssd1306_display *display,
+                              const struct bench_input *input) {
+    ssd1306_draw_rect_round_fill(display, input->v[0], input->v[1],
+                                 input->v[2], input->v[3], input->v[4]);
+}
+
+static void r_arc(struct ssd1306_display *display,
+                  const struct bench_input *input) {
+    ssd1306_draw_arc(display, input->v[0], input->v[1], input->v[2],
+                     (uint8_t)input->v[3]);
+}
+
+static void r_arc_fill(struct ssd1306_display *display,
+                       const struct bench_input *input) {
+    ssd1306_draw_arc_fill(display, input->v[0], input->v[1], input->v[2],
+                          (uint8_t)input->v[3]);
+}
+
+static void r_circle(struct ssd1306_display *display,
+                     const struct bench_input *input) {
+    ssd1306_draw_circle(display, input->v[0], input->v[1], input->v[2]);
+}
+
+static void r_circle_fill(struct ssd1306_display *display,
+                          const struct bench_input *input) {
+    ssd1306_draw_circle_fill(display, input->v[0], input->v[1], input->v[2]);
+}
+
+static void r_bitmap(struct ssd1306_display *display,
+                     const struct bench_input *input) {
+    ssd1306_draw_bitmap(display, input->v[0], input->v[1], bench_bitmap,
+                        (uint16_t)input->v[2], (uint16_t)input->v[3], true);
+}
+
+static void r_bitmap_native(struct ssd1306_display *display,
+                            const struct bench_input *input) {
+    ssd1306_draw_bitmap_native(display, input->v[0], input->v[1], bench_bitmap,
+                               (uint16_t)input->v[2], (uint16_t)input->v[3],
+                               (enum ssd1306_bitmap_mode)input->v[4]);
+}
+
+static void r_char(struct ssd1306_display *display,
+                   const struct bench_input *input) {
+    ssd1306_set_font_scale(display, (uint8_t)input->v[2]);
+    ssd1306_set_cursor(display, input->v[0], input->v[1]);
+    ssd1306_draw_char(display, 'W');
+}
+
+static void r_char_custom(struct ssd1306_display *display,
+                          const struct bench_input *input) {
+    ssd1306_set_font_scale(display, (uint8_t)input->v[2]);
+    ssd1306_set_cursor(display, input->v[0], input->v[1]);
+    ssd1306_draw_char_custom(display, &bench_custom_char);
+}
+
+static void r_str(struct ssd1306_display *display,
+                  const struct bench_input *input) {
+    ssd1306_set_font_scale(display, (uint8_t)input->v[2]);
+    ssd1306_set_cursor(display, input->v[0], input->v[1]);
+    ssd1306_draw_str(display, BENCH_TEXT);
+}
+
+static void r_int32(struct ssd1306_display *display,
+                    const struct bench_input *input) {
+    ssd1306_set_font_scale(display, (uint8_t)input->v[2]);
+    ssd1306_set_cursor(display, input->v[0], input->v[1]);
+    ssd1306_draw_int32(display, -2147483647);
+}
+
+static void r_float(struct ssd1306_display *display,
+                    const struct bench_input *input) {
+    ssd1306_set_font_scale(display, (uint8_t)input->v[2]);
+    ssd1306_set_cursor(display, input->v[0], input->v[1]);
+    ssd1306_draw_float(display, -12345.678f, 3);
+}
+
+static void r_printf(struct ssd1306_display *display,
+                     const struct bench_input *input) {
+    ssd1306_set_font_scale(display, (uint8_t)input->v[2]);
+    ssd1306_set_cursor(display, input->v[0], input->v[1]);
+    ssd1306_draw_printf(display, "x=%d y=%d %s", input->v[0], input->v[1],
+                        "ok");
+}
+
+static void r_rect_fill_rotated(struct ssd1306_display *display,
+                                const struct bench_input *input) {
+    ssd1306_set_rotation(display, SSD1306_ROTATION_90);
+    ssd1306_draw_rect_fill(display, input->v[0], input->v[1], input->v[2],
+                           input->v[3]);
+}
+
+static void r_str_rotated(struct ssd1306_display *display,
+                          const struct bench_input *input) {
+    ssd1306_set_rotation(display, SSD1306_ROTATION_90);
+    ssd1306_set_font_scale(display, (uint8_t)input->v[2]);
+    ssd1306_set_cursor(display, input->v[0], input->v[1]);
+    ssd1306_draw_str(display, BENCH_TEXT);
+}
+
+static void r_rotate_frame(struct ssd1306_display *display,
+                           const struct bench_input *input) {
+    (void)input;
+    uint8_t x_min, y_min, x_max, y_max;
+    ssd1306_set_rotation(display, SSD1306_ROTATION_90);
+    ssd1306_get_draw_border(display, &x_min, &y_min, &x_max, &y_max);
+    ssd1306_draw_bitmap_native(display, 0, 0, bench_bitmap, x_max + 1,
+                               y_max + 1, SSD1306_BITMAP_MODE_OPAQUE);
+}
+
+static void r_sprite_xor(struct ssd1306_display *display,
+                         const struct bench_input *input) {
+    /* Erase-free animation: XOR out the old frame, XOR in the new one */
+    ssd1306_set_buffer_mode(display, SSD1306_BUFFER_MODE_XOR);
+    ssd1306_draw_rect_round(display, input->v[0], input->v[1], input->v[2],
+                            input->v[3], 3);
+    ssd1306_draw_rect_round(display, input->v[0] + 1, input->v[1],
+                            input->v[2], input->v[3], 3);
+}
+
+static void r_update(struct ssd1306_display *display,
+                     const struct bench_input *input) {
+    /* A small change per frame, like a typical UI */
+    ssd1306_set_buffer_mode_inverse(display);
+    ssd1306_draw_rect_fill(display, input->v[0], input->v[1], 8, 8);
+    ssd1306_set_buffer_mode_inverse(display);
+    ssd1306_display_update(display);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------- Cases ----------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+static const struct bench_case bench_cases[] = {
+    {"ssd1306_draw_clear", g_none, r_clear, 0, true},
+    {"ssd1306_draw_fill", g_none, r_fill, 0, true},
+    {"ssd1306_draw_invert", g_none, r_invert, 0, true},
+    {"ssd1306_draw_mirror_h", g_none, r_mirror_h, 0, true},
+    {"ssd1306_draw_mirror_v", g_none, r_mirror_v, 0, true},
+    {"ssd1306_draw_shift_right", g_none, r_shift_right, 0, true},
+    {"ssd1306_draw_shift_left", g_none, r_shift_left, 0, true},
+    {"ssd1306_draw_shift_up", g_none, r_shift_up, 0, true},
+    {"ssd1306_draw_shift_up (not rotated)", g_none, r_shift_up_plain, 0, true},
+    {"ssd1306_draw_shift_down", g_none, r_shift_down, 0, true},
+    {"ssd1306_draw_shift_right_by (5)", g_count, r_shift_right_by, 5, true},
+    {"ssd1306_draw_shift_left_by (5)", g_count, r_shift_left_by, 5, true},
+    {"ssd1306_draw_shift_up_by (5)", g_count, r_shift_up_by, 5, true},
+    {"ssd1306_draw_shift_down_by (5)", g_count, r_shift_down_by, 5, true},
+    {"ssd1306_draw_invert (40px pane)", g_pane, r_pane_invert, 0, true},
+    {"ssd1306_draw_shift_up_by (40px pane, 5)", g_pane, r_pane_shift_up_by, 5,
+     true},
+    {"ssd1306_draw_pixel", g_point, r_pixel, 0, false},
+    {"ssd1306_draw_line_h", g_line_hv, r_line_h, 0, false},
+    {"ssd1306_draw_line_v", g_line_hv, r_line_v, 0, false},
+    {"ssd1306_draw_line", g_two_points, r_line, 0, false},
+    {"ssd1306_draw_line (shallow)", g_two_points, r_line, 1, false},
+    {"ssd1306_draw_line (steep)", g_two_points, r_line, 2, false},
+    {"per-pixel line (reference)", g_two_points, r_line_reference, 0, false},
+    {"per-pixel line (reference, shallow)", g_two_points, r_line_reference, 1,
+     false},
+    {"per-pixel line (reference, steep)", g_two_points, r_line_reference, 2,
+     false},
+    {"ssd1306_draw_triangle", g_triangle, r_triangle, 0, false},
+    {"ssd1306_draw_triangle_fill", g_triangle, r_triangle_fill, 0, false},
+    {"ssd1306_draw_polygon (8)", g_polygon, r_polygon, 1, false},
+    {"ssd1306_draw_polygon_fill (8)", g_polygon, r_polygon_fill, 0, false},
+    {"ssd1306_draw_triangle_fill (x6)", g_polygon, r_polygon_fan, 0, false},
+    {"ssd1306_draw_rect", g_rect, r_rect, 0, false},
+    {"ssd1306_draw_rect_fill", g_rect, r_rect_fill, 0, false},
+    {"ssd1306_draw_rect_round", g_rect, r_rect_round, 0, false},
+    {"ssd1306_draw_rect_round_fill", g_rect, r_rect_round_fill, 0, false},
+    {"ssd1306_draw_arc", g_circle, r_arc, 0, false},
+    {"ssd1306_draw_arc_fill", g_circle, r_arc_fill, 0, false},
+    {"ssd1306_draw_circle", g_circle, r_circle, 0, false},
+    {"ssd1306_draw_circle_fill", g_circle, r_circle_fill, 0, false},
+    {"ssd1306_draw_bitmap", g_bitmap, r_bitmap, 0, false},
+    {"ssd1306_draw_bitmap_native (transparent)", g_bitmap, r_bitmap_native,
+     SSD1306_BITMAP_MODE_TRANSPARENT, false},
+    {"ssd1306_draw_bitmap_native (opaque)", g_bitmap, r_bitmap_native,
+     SSD1306_BITMAP_MODE_OPAQUE, false},
+    {"ssd1306_draw_char (x1)", g_text, r_char, 1, false},
+    {"ssd1306_draw_char (x4)", g_text, r_char, 4, false},
+    {"ssd1306_draw_char_custom (x1)", g_text, r_char_custom, 1, false},
+    {"ssd1306_draw_str (x1)", g_text, r_str, 1, false},
+    {"ssd1306_draw_str (x2)", g_text, r_str, 2, false},
+    {"ssd1306_draw_str (x3)", g_text, r_str, 3, false},
+    {"ssd1306_draw_str (x4)", g_text, r_str, 4, false},
+    {"ssd1306_draw_int32 (x1)", g_text, r_int32, 1, false},
+    {"ssd1306_draw_float (x1)", g_text, r_float, 1, false},
+    {"ssd1306_draw_printf (x1)", g_text, r_printf, 1, false},
+    {"ssd1306_draw_rect_fill (rotated 90)", g_rect, r_rect_fill_rotated, 0,
+     false},
+    {"ssd1306_draw_str (x1, rotated 90)", g_text, r_str_rotated, 1, false},
+    {"ssd1306_draw_bitmap_native (rotated 90)", g_none, r_rotate_frame, 0,
+     true},
+    {"ssd1306_draw_rect_round (XOR, x2)", g_rect, r_sprite_xor, 0, false},
+    {"ssd1306_display_update (full)", g_point, r_update,
+     SSD1306_UPDATE_MODE_FULL, true},
+    {"ssd1306_display_update (dirty)", g_point, r_update,
+     SSD1306_UPDATE_MODE_DIRTY, true},
+#if SSD1306_SHADOW_BUFFER == true
+    {"ssd1306_display_update (diff)", g_point, r_update,
+     SSD1306_UPDATE_MODE_DIFF, true},
+#endif
+};
+
+/*----------------------------------------------------------------------------*/
+/*--------------------------------- Benchmark --------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Prints to the console and to the report file (if any).
+ */
+static void h_report(FILE *file, const char *line) {
+    fputs(line, stdout);
+    if (file)
+        fputs(line, file);
+}
+
+/**
+ * @brief Prepares the display for a case (default state, case specific
+ * update mode).
+ */
+static void h_prepare(struct ssd1306_display *display,
+                      const struct bench_case *bench_case) {
+    ssd1306_set_buffer_mode(display, SSD1306_BUFFER_MODE_DRAW);
+    ssd1306_set_font(display, &bench_font);
+    ssd1306_set_font_scale(display, 1);
+    ssd1306_set_rotation(display, SSD1306_ROTATION_0);
+    ssd1306_set_draw_border_reset(display);
+    ssd1306_set_transform_mode(display, SSD1306_TRANSFORM_MODE_FULL);
+    if (bench_case->run == r_update)
+        ssd1306_set_update_mode(display,
+                                (enum ssd1306_update_mode)bench_case->param);
+    else
+        ssd1306_set_update_mode(display, SSD1306_UPDATE_MODE_DIRTY);
+    ssd1306_draw_clear(display);
+}
+
+/**
+ * @brief Benchmarks a case with one input set.
+ *
+ * @return 'false' if the display contents didn't match the emulator.
+ */
+static bool h_run_case(struct ssd1306_display *display,
+                       struct ssd1306_emulator *emulator,
+                       const struct bench_case *bench_case, bool is_worst,
+                       uint16_t input_count, bool is_smoke, FILE *file) {
+    static struct bench_input inputs[BENCH_INPUT_COUNT];
+    int16_t height = 32;
+    if (ssd1306_get_display_type(display))
+        height = 64;
+
+    bench_random_state = 0xC0FFEE + (uint32_t)is_worst;
+    memset(inputs, 0, sizeof(inputs));
+    for (uint16_t i = 0; i < input_count; i++)
+        bench_case->generate(&inputs[i], height, is_worst, bench_case->param);
+
+    /* Pixels covered by the inputs (not timed) */
+    uint64_t pixels = 0;
+    h_prepare(display, bench_case);
+    for (uint16_t i = 0; i < input_count; i++) {
+        if (bench_case->is_whole_buffer) {
+            pixels += (uint64_t)128 * (uint64_t)height;
+            continue;
+        }
+        ssd1306_draw_clear(display);
+        bench_case->run(display, &inputs[i]);
+        pixels += h_count_pixels(display);
+    }
+
+    /* Double the rounds until the measurement is long enough */
+    h_prepare(display, bench_case);
+    uint32_t rounds = 1;
+    uint64_t elapsed;
+    while (1) {
+        uint64_t start = h_now_ns();
+        for (uint32_t r = 0; r < rounds; r++) {
+            for (uint16_t i = 0; i < input_count; i++)
+                bench_case->run(display, &inputs[i]);
+        }
+        elapsed = h_now_ns() - start;
+        if (is_smoke || elapsed >= BENCH_MIN_TIME_NS || rounds >= (1u << 24))
+            break;
+        rounds *= 2;
+    }
+
+    /* The display must hold the buffer after an update */
+    ssd1306_display_update(display);
+    while (ssd1306_display_is_busy(display)) {
+    }
+    bool is_match = ssd1306_emulator_compare(emulator, display);
+
+    double calls = (double)rounds * (double)input_count;
+    double ns_per_call = (double)elapsed / calls;
+    double ns_per_pixel = 0;
+    double pixels_per_call = (double)pixels / (double)input_count;
+    if (pixels)
+        ns_per_pixel = (double)elapsed / ((double)rounds * (double)pixels);
+
+    char line[160];
+    snprintf(line, sizeof(line), "%-40s %-6s %12.1f %10.3f %12.1f%s\n",
+             bench_case->name, is_worst ? "worst" : "random", ns_per_call,
+             ns_per_pixel, pixels_per_call, is_match ? "" : "  MISMATCH");
+    h_report(file, line);
+    return is_match;
+}
+
+int main(int argc, char **argv) {
+    bool is_smoke = false;
+    const char *output = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--smoke") == 0) {
+            is_smoke = true;
+        } else if (strcmp(argv[i], "-o") == 0 && (i + 1) < argc) {
+            output = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--smoke] [-o FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *file = NULL;
+    if (output) {
+        file = fopen(output, "w");
+        if (!file) {
+            perror(output);
+            return 2;
+        }
+    }
+
+    uint16_t input_count = BENCH_INPUT_COUNT;
+    if (is_smoke)
+        input_count = BENCH_SMOKE_INPUT_COUNT;
+
+    h_setup_resources();
+
+    static uint8_t array[SSD1306_ARRAY_SIZE_64];
+    struct ssd1306_display display;
+    struct ssd1306_emulator emulator;
+    bool is_passed = true;
+    char line[160];
+
+    for (uint8_t type = 0; type < 2; type++) {
+        enum ssd1306_display_type display_type;
+        display_type = (enum ssd1306_display_type)type;
+        ssd1306_emulator_init(&emulator, display_type, 0x3C);
+        ssd1306_init_transport(&display, display_type, array,
+                               &ssd1306_emulator_transport_i2c, &emulator);
+
+        snprintf(line, sizeof(line), "\nSSD1306 benchmark, 128x%d%s\n",
+                 type ? 64 : 32, is_smoke ? " (smoke run)" : "");
+        h_report(file, line);
+        snprintf(line, sizeof(line), "%-40s %-6s %12s %10s %12s\n", "function",
+                 "input", "ns/call", "ns/pixel", "pixels/call");
+        h_report(file, line);
+
+        size_t count = sizeof(bench_cases) / sizeof(bench_cases[0]);
+        for (size_t i = 0; i < count; i++) {
+            for (uint8_t is_worst = 0; is_worst < 2; is_worst++) {
+                if (!h_run_case(&display, &emulator, &bench_cases[i], is_worst,
+                                input_count, is_smoke, file))
+                    is_passed = false;
+            }
+        }
+
+        if (emulator.protocol_errors) {
+            snprintf(line, sizeof(line), "Protocol errors: %lu\n",
+                     (unsigned long)emulator.protocol_errors);
+            h_report(file, line);
+            is_passed = false;
+        }
+    }
+
+    if (file)
+        fclose(file);
+    return is_passed ? 0 : 1;
+}
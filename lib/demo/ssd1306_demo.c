@@ -90,8 +90,15 @@ void ssd1306_demo_1(struct ssd1306_display *display, uint16_t delay) {
     int8_t bitmap_x0 = 0;
     int8_t bitmap_y0 = 0;
 
-    ssd1306_set_buffer_mode(display, SSD1306_BUFFER_MODE_DRAW);
+    /* In XOR mode, drawing the logo again erases it, no need to clear */
+    ssd1306_draw_clear(display);
+    ssd1306_set_buffer_mode(display, SSD1306_BUFFER_MODE_XOR);
+    ssd1306_draw_bitmap(display, bitmap_x0, bitmap_y0, BITMAP, BITMAP_WIDTH,
+                        BITMAP_HEIGHT, false);
     while (1) {
+        ssd1306_draw_bitmap(display, bitmap_x0, bitmap_y0, BITMAP, BITMAP_WIDTH,
+                            BITMAP_HEIGHT, false);
+
         if (x_dir == POSITIVE)
             bitmap_x0++;
         else
@@ -108,7 +115,6 @@ void ssd1306_demo_1(struct ssd1306_display *display, uint16_t delay) {
         if ((bitmap_y0 == 0) || ((bitmap_y0 + BITMAP_HEIGHT) == SSD1306_Y_MAX))
             y_dir ^= 1;
 
-        ssd1306_draw_clear(display);
         ssd1306_draw_bitmap(display, bitmap_x0, bitmap_y0, BITMAP, BITMAP_WIDTH,
                             BITMAP_HEIGHT, false);
         ssd1306_display_update(display);
@@ -0,0 +1,644 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2024 Ahmet Burak Irmak (https://youtube.com/Microesque)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Library GitHub Page:   https://github.com/Microesque/SSD1306
+ * Library Documentation: https://github.com/Microesque/SSD1306/wiki
+ */
+
+/*----------------------------------------------------------------------------*/
+/*---------------------------- Necessary Libraries ---------------------------*/
+/*----------------------------------------------------------------------------*/
+
+#include "ssd1306_emulator.h"
+
+#include <string.h>
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------ Emulator Setup ------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/* I2C control byte bits (data-sheet p20) */
+#define SSD1306_EMULATOR_CONTROL_CO 0x80
+#define SSD1306_EMULATOR_CONTROL_DC 0x40
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------- Helper Functions -----------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Returns the total length (command + parameters) of the specified
+ * command (data-sheet p28-32).
+ *
+ * @param cmd The first byte of the command.
+ * @return The length of the command; 0 for unknown commands.
+ */
+static uint8_t h_get_cmd_length(uint8_t cmd) {
+    switch (cmd) {
+    case 0x20: /* Memory addressing mode */
+    case 0x81: /* Contrast */
+    case 0x8D: /* Charge pump */
+    case 0xA8: /* Mux ratio */
+    case 0xD3: /* Display offset */
+    case 0xD5: /* Clock divide ratio / oscillator frequency */
+    case 0xD9: /* Pre-charge period */
+    case 0xDA: /* COM pins configuration */
+    case 0xDB: /* VCOMH deselect level */
+    case 0x23: /* Fade out / blinking */
+    case 0xD6: /* Zoom in */
+        return 2;
+    case 0x21: /* Column address */
+    case 0x22: /* Page address */
+    case 0xA3: /* Vertical scroll area */
+        return 3;
+    case 0x29: /* Diagonal scroll setup */
+    case 0x2A:
+        return 6;
+    case 0x26: /* Horizontal scroll setup */
+    case 0x27:
+    case 0x2C: /* Content scroll setup */
+    case 0x2D:
+        return 7;
+    }
+
+    if (cmd <= 0x1F)              /* Page mode column start */
+        return 1;
+    if (cmd >= 0x40 && cmd <= 0x7F) /* Display start line */
+        return 1;
+    if (cmd >= 0xB0 && cmd <= 0xB7) /* Page mode page start */
+        return 1;
+    switch (cmd) {
+    case 0x2E: /* Scroll disable */
+    case 0x2F: /* Scroll enable */
+    case 0xA0: /* Segment remap */
+    case 0xA1:
+    case 0xA4: /* Entire display on */
+    case 0xA5:
+    case 0xA6: /* Inverse */
+    case 0xA7:
+    case 0xAE: /* Display on/off */
+    case 0xAF:
+    case 0xC0: /* COM scan direction */
+    case 0xC8:
+    case 0xE3: /* NOP */
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Executes a complete command stored in the command parser.
+ *
+ * @param emulator Pointer to the ssd1306_emulator structure.
+ */
+static void h_execute_cmd(struct ssd1306_emulator *emulator) {
+    uint8_t *cmd = emulator->cmd;
+    bool is_page_mode;
+    is_page_mode =
+        (emulator->addressing_mode == SSD1306_EMULATOR_ADDRESSING_PAGE);
+
+    if (cmd[0] <= 0x0F) {
+        emulator->page_mode_column_start =
+            (emulator->page_mode_column_start & 0xF0) | cmd[0];
+        if (is_page_mode)
+            emulator->column = emulator->page_mode_column_start;
+        return;
+    }
+    if (cmd[0] <= 0x1F) {
+        emulator->page_mode_column_start =
+            (uint8_t)((emulator->page_mode_column_start & 0x0F) |
+                      ((cmd[0] & 0x07) << 4));
+        if (is_page_mode)
+            emulator->column = emulator->page_mode_column_start;
+        return;
+    }
+    if (cmd[0] >= 0x40 && cmd[0] <= 0x7F) {
+        emulator->start_line = cmd[0] & 0x3F;
+        return;
+    }
+    if (cmd[0] >= 0xB0 && cmd[0] <= 0xB7) {
+        if (is_page_mode)
+            emulator->page = cmd[0] & 0x07;
+        return;
+    }
+
+    switch (cmd[0]) {
+    case 0x20:
+        if ((cmd[1] & 0x03) <= 2)
+            emulator->addressing_mode =
+                (enum ssd1306_emulator_addressing_mode)(cmd[1] & 0x03);
+        else
+            emulator->protocol_errors++;
+        break;
+    case 0x21:
+        /* Only for horizontal and vertical addressing modes */
+        if (is_page_mode)
+            break;
+        emulator->column_start = cmd[1] & 0x7F;
+        emulator->column_end = cmd[2] & 0x7F;
+        emulator->column = emulator->column_start;
+        break;
+    case 0x22:
+        if (is_page_mode)
+            break;
+        emulator->page_start = cmd[1] & 0x07;
+        emulator->page_end = cmd[2] & 0x07;
+        emulator->page = emulator->page_start;
+        break;
+    case 0x81:
+        emulator->contrast = cmd[1];
+        break;
+    case 0x8D:
+        emulator->charge_pump = cmd[1];
+        break;
+    case 0xA8:
+        emulator->mux_ratio = cmd[1] & 0x3F;
+        break;
+    case 0xD3:
+        emulator->display_offset = cmd[1] & 0x3F;
+        break;
+    case 0xD5:
+        emulator->div_ratio_and_freq = cmd[1];
+        break;
+    case 0xD9:
+        emulator->precharge_period = cmd[1];
+        break;
+    case 0xDA:
+        emulator->com_configuration = cmd[1];
+        break;
+    case 0xDB:
+        emulator->vcomh_level = cmd[1];
+        break;
+    case 0xA3:
+        emulator->vertical_scroll_top = cmd[1] & 0x3F;
+        emulator->vertical_scroll_rows = cmd[2] & 0x7F;
+        break;
+    case 0x26:
+    case 0x27:
+    case 0x29:
+    case 0x2A:
+        /* Data-sheet p46, the scroll must be disabled during the setup */
+        if (emulator->is_scrolling)
+            emulator->protocol_errors++;
+        emulator->scroll_cmd = cmd[0];
+        emulator->scroll_page_start = cmd[2] & 0x07;
+        emulator->scroll_interval = cmd[3] & 0x07;
+        emulator->scroll_page_end = cmd[4] & 0x07;
+        if (cmd[0] == 0x29 || cmd[0] == 0x2A)
+            emulator->scroll_vertical_offset = cmd[5] & 0x3F;
+        else
+            emulator->scroll_vertical_offset = 0;
+        break;
+    case 0x2E:
+        emulator->is_scrolling = false;
+        break;
+    case 0x2F:
+        emulator->is_scrolling = true;
+        break;
+    case 0xA0:
+    case 0xA1:
+        emulator->is_segment_remap = (cmd[0] == 0xA1);
+        break;
+    case 0xA4:
+    case 0xA5:
+        emulator->is_entire_display_on = (cmd[0] == 0xA5);
+        break;
+    case 0xA6:
+    case 0xA7:
+        emulator->is_inverse = (cmd[0] == 0xA7);
+        break;
+    case 0xAE:
+    case 0xAF:
+        emulator->is_display_on = (cmd[0] == 0xAF);
+        break;
+    case 0xC0:
+    case 0xC8:
+        emulator->is_scan_remap = (cmd[0] == 0xC8);
+        break;
+    default:
+        /* Fade, zoom, content scroll and NOP don't affect the contents */
+        break;
+    }
+}
+
+/**
+ * @brief Feeds a command byte to the command parser.
+ *
+ * @param emulator Pointer to the ssd1306_emulator structure.
+ * @param byte The command byte.
+ */
+static void h_write_cmd_byte(struct ssd1306_emulator *emulator, uint8_t byte) {
+    if (emulator->cmd_length == 0) {
+        emulator->cmd_expected = h_get_cmd_length(byte);
+        if (emulator->cmd_expected == 0) {
+            emulator->protocol_errors++;
+            return;
+        }
+    }
+
+    emulator->cmd[emulator->cmd_length++] = byte;
+    if (emulator->cmd_length == emulator->cmd_expected) {
+        h_execute_cmd(emulator);
+        emulator->cmd_length = 0;
+    }
+}
+
+/**
+ * @brief Writes a data byte to the GDDRAM, and advances the address pointer
+ * according to the addressing mode (data-sheet p34-36).
+ *
+ * @param emulator Pointer to the ssd1306_emulator structure.
+ * @param byte The data byte.
+ */
+static void h_write_data_byte(struct ssd1306_emulator *emulator, uint8_t byte) {
+    emulator->gddram[(emulator->page * 128) + emulator->column] = byte;
+    if (emulator->is_scrolling)
+        emulator->scroll_writes++;
+
+    switch (emulator->addressing_mode) {
+    case SSD1306_EMULATOR_ADDRESSING_HORIZONTAL:
+        if (emulator->column < emulator->column_end) {
+            emulator->column++;
+            break;
+        }
+        emulator->column = emulator->column_start;
+        if (emulator->page < emulator->page_end)
+            emulator->page++;
+        else
+            emulator->page = emulator->page_start;
+        break;
+    case SSD1306_EMULATOR_ADDRESSING_VERTICAL:
+        if (emulator->page < emulator->page_end) {
+            emulator->page++;
+            break;
+        }
+        emulator->page = emulator->page_start;
+        if (emulator->column < emulator->column_end)
+            emulator->column++;
+        else
+            emulator->column = emulator->column_start;
+        break;
+    case SSD1306_EMULATOR_ADDRESSING_PAGE:
+        if (emulator->column < 127)
+            emulator->column++;
+        else
+            emulator->column = emulator->page_mode_column_start;
+        break;
+    }
+}
+
+/**
+ * @brief Feeds the transaction of an emulator transport to the emulator.
+ *
+ * @note
+ * - With SSD1306_ASYNC_TRANSFER, the transfer is reported complete right away.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param bytes Pointer to the command/data bytes.
+ * @param length The number of bytes.
+ * @param is_data 'true' for data; 'false' for commands.
+ * @param is_i2c 'true' to emulate I2C; 'false' to emulate SPI.
+ */
+static void h_transport_write(struct ssd1306_display *display, uint8_t *bytes,
+                              uint16_t length, bool is_data, bool is_i2c) {
+    struct ssd1306_emulator *emulator;
+    emulator = ssd1306_get_transport_context(display);
+
+    if (is_i2c) {
+        /* Same header as the I2C transport */
+        *(bytes - 2) = (uint8_t)(emulator->i2c_address << 1);
+        if (is_data)
+            *(bytes - 1) = SSD1306_EMULATOR_CONTROL_DC;
+        else
+            *(bytes - 1) = 0x00;
+        ssd1306_emulator_i2c_write(emulator, bytes - 2, length + 2);
+    } else {
+        ssd1306_emulator_spi_write(emulator, bytes, length, is_data);
+    }
+
+#if SSD1306_ASYNC_TRANSFER == true
+    ssd1306_transfer_complete(display);
+#endif
+}
+
+/**
+ * @brief Feeds commands to the emulator as an I2C transaction.
+ */
+static void h_i2c_write_cmd(struct ssd1306_display *display, uint8_t *cmd,
+                            uint16_t length) {
+    h_transport_write(display, cmd, length, false, true);
+}
+
+/**
+ * @brief Feeds data to the emulator as an I2C transaction.
+ */
+static void h_i2c_write_data(struct ssd1306_display *display, uint8_t *data,
+                             uint16_t length) {
+    h_transport_write(display, data, length, true, true);
+}
+
+/**
+ * @brief Feeds commands to the emulator as an SPI transaction.
+ */
+static void h_spi_write_cmd(struct ssd1306_display *display, uint8_t *cmd,
+                            uint16_t length) {
+    h_transport_write(display, cmd, length, false, false);
+}
+
+/**
+ * @brief Feeds data to the emulator as an SPI transaction.
+ */
+static void h_spi_write_data(struct ssd1306_display *display, uint8_t *data,
+                             uint16_t length) {
+    h_transport_write(display, data, length, true, false);
+}
+
+/*----------------------------------------------------------------------------*/
+/*--------------------------- Available Transports ---------------------------*/
+/*----------------------------------------------------------------------------*/
+
+const struct ssd1306_transport ssd1306_emulator_transport_i2c = {
+    h_i2c_write_cmd, h_i2c_write_data, 2};
+
+const struct ssd1306_transport ssd1306_emulator_transport_spi = {
+    h_spi_write_cmd, h_spi_write_data, 0};
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------ Init Functions ------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Initializes the ssd1306_emulator structure as a freshly powered
+ * display.
+ *
+ * @note
+ * - The GDDRAM contents of a real display are random after power-up. The
+ * emulator fills them with 0xA5 so that unwritten bytes stand out.
+ *
+ * - To drive the emulator with the library, pass it as the context to
+ * ssd1306_init_transport() along with ssd1306_emulator_transport_i2c or
+ * ssd1306_emulator_transport_spi. The raw transactions of any other source
+ * can be fed with ssd1306_emulator_i2c_write() or ssd1306_emulator_spi_write().
+ *
+ * @param emulator Pointer to the ssd1306_emulator structure.
+ * @param display_type Panel size (128x32 or 128x64), used by
+ * ssd1306_emulator_get_pixel().
+ * @param i2c_address 7-bit I2C address of the emulated display.
+ */
+void ssd1306_emulator_init(struct ssd1306_emulator *emulator,
+                           enum ssd1306_display_type display_type,
+                           uint8_t i2c_address) {
+    emulator->display_type = display_type;
+    emulator->i2c_address = i2c_address;
+    memset(emulator->gddram, 0xA5, sizeof(emulator->gddram));
+    ssd1306_emulator_reset_stats(emulator);
+    ssd1306_emulator_reset(emulator);
+}
+
+/**
+ * @brief Emulates a hardware reset (RES# pin). All registers return to their
+ * reset values (data-sheet p27-32).
+ *
+ * @note
+ * - The GDDRAM contents and the statistics are kept.
+ *
+ * @param emulator Pointer to the ssd1306_emulator structure.
+ */
+void ssd1306_emulator_reset(struct ssd1306_emulator *emulator) {
+    emulator->addressing_mode = SSD1306_EMULATOR_ADDRESSING_PAGE;
+    emulator->column = 0;
+    emulator->page = 0;
+    emulator->column_start = 0;
+    emulator->column_end = 127;
+    emulator->page_start = 0;
+    emulator->page_end = 7;
+    emulator->page_mode_column_start = 0;
+
+    emulator->contrast = 0x7F;
+    emulator->mux_ratio = 63;
+    emulator->display_offset = 0;
+    emulator->start_line = 0;
+    emulator->com_configuration = 0x12;
+    emulator->div_ratio_and_freq = 0x80;
+    emulator->precharge_period = 0x22;
+    emulator->vcomh_level = 0x20;
+    emulator->charge_pump = 0x10;
+    emulator->vertical_scroll_top = 0;
+    emulator->vertical_scroll_rows = 64;
+    emulator->is_display_on = false;
+    emulator->is_entire_display_on = false;
+    emulator->is_inverse = false;
+    emulator->is_segment_remap = false;
+    emulator->is_scan_remap = false;
+
+    emulator->is_scrolling = false;
+    emulator->scroll_cmd = 0;
+    emulator->scroll_page_start = 0;
+    emulator->scroll_page_end = 0;
+    emulator->scroll_interval = 0;
+    emulator->scroll_vertical_offset = 0;
+
+    emulator->cmd_length = 0;
+    emulator->cmd_expected = 0;
+}
+
+/**
+ * @brief Resets the bus statistics and the error counters of the emulator.
+ *
+ * @param emulator Pointer to the ssd1306_emulator structure.
+ */
+void ssd1306_emulator_reset_stats(struct ssd1306_emulator *emulator) {
+    emulator->transactions = 0;
+    emulator->bytes = 0;
+    emulator->cmd_transactions = 0;
+    emulator->cmd_bytes = 0;
+    emulator->data_transactions = 0;
+    emulator->data_bytes = 0;
+    emulator->protocol_errors = 0;
+    emulator->scroll_writes = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------- Bus Functions ------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Feeds a complete I2C write transaction (address byte included) to
+ * the emulator.
+ *
+ * @note
+ * - Supports both single (Co = 1) and streamed (Co = 0) control bytes
+ * (data-sheet p20). Transactions to other addresses are ignored and counted
+ * as protocol errors.
+ *
+ * @param emulator Pointer to the ssd1306_emulator structure.
+ * @param data Pointer to the transaction bytes.
+ * @param length The number of bytes, including the address byte.
+ */
+void ssd1306_emulator_i2c_write(struct ssd1306_emulator *emulator,
+                                const uint8_t *data, uint16_t length) {
+    emulator->transactions++;
+    emulator->bytes += length;
+    if (length < 2 || data[0] != (uint8_t)(emulator->i2c_address << 1)) {
+        emulator->protocol_errors++;
+        return;
+    }
+
+    bool is_data = false;
+    uint16_t i = 1;
+    while (i < length) {
+        uint8_t control = data[i++];
+        is_data = control & SSD1306_EMULATOR_CONTROL_DC;
+        if (!(control & SSD1306_EMULATOR_CONTROL_CO))
+            break;
+
+        /* Co = 1, a single byte follows the control byte */
+        if (i >= length)
+            break;
+        if (is_data)
+            h_write_data_byte(emulator, data[i++]);
+        else
+            h_write_cmd_byte(emulator, data[i++]);
+    }
+
+    if (is_data) {
+        emulator->data_transactions++;
+        emulator->data_bytes += length - i;
+        for (; i < length; i++)
+            h_write_data_byte(emulator, data[i]);
+    } else {
+        emulator->cmd_transactions++;
+        emulator->cmd_bytes += length - i;
+        for (; i < length; i++)
+            h_write_cmd_byte(emulator, data[i]);
+    }
+}
+
+/**
+ * @brief Feeds a complete 4-wire SPI transaction to the emulator.
+ *
+ * @param emulator Pointer to the ssd1306_emulator structure.
+ * @param data Pointer to the transaction bytes.
+ * @param length The number of bytes.
+ * @param is_data State of the D/C pin ('true' -> data; 'false' -> commands).
+ */
+void ssd1306_emulator_spi_write(struct ssd1306_emulator *emulator,
+                                const uint8_t *data, uint16_t length,
+                                bool is_data) {
+    emulator->transactions++;
+    emulator->bytes += length;
+    if (length == 0) {
+        emulator->protocol_errors++;
+        return;
+    }
+
+    if (is_data) {
+        emulator->data_transactions++;
+        emulator->data_bytes += length;
+        for (uint16_t i = 0; i < length; i++)
+            h_write_data_byte(emulator, data[i]);
+    } else {
+        emulator->cmd_transactions++;
+        emulator->cmd_bytes += length;
+        for (uint16_t i = 0; i < length; i++)
+            h_write_cmd_byte(emulator, data[i]);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------- Get Functions ------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Returns the GDDRAM of the emulator.
+ *
+ * @note
+ * - The GDDRAM uses the same page-major layout as the library buffer (byte
+ * "page * 128 + x" holds the pixels x, [page * 8 ... page * 8 + 7], LSB on
+ * top). 128x32 displays only use the first 4 pages.
+ *
+ * @param emulator Pointer to the ssd1306_emulator structure.
+ * @return Pointer to the 1024 byte GDDRAM.
+ */
+const uint8_t *ssd1306_emulator_get_gddram(struct ssd1306_emulator *emulator) {
+    return emulator->gddram;
+}
+
+/**
+ * @brief Returns the state of a pixel as seen on the panel.
+ *
+ * @note
+ * - Takes the display on/off, entire display on, inverse, segment remap, COM
+ * scan direction, start line and display offset into account. Assumes the
+ * COM pins configuration matches the panel, and ignores the scroll animation.
+ *
+ * @param emulator Pointer to the ssd1306_emulator structure.
+ * @param x X coordinate of the pixel on the panel.
+ * @param y Y coordinate of the pixel on the panel.
+ * @return 'true' if the pixel is lit; 'false' otherwise or if out of bounds.
+ */
+bool ssd1306_emulator_get_pixel(struct ssd1306_emulator *emulator, uint8_t x,
+                                uint8_t y) {
+    uint8_t height;
+    if (emulator->display_type)
+        height = 64;
+    else
+        height = 32;
+    if (x > 127 || y >= height || y > emulator->mux_ratio)
+        return false;
+    if (!emulator->is_display_on)
+        return false;
+    if (emulator->is_entire_display_on)
+        return true;
+
+    uint8_t column = x;
+    if (emulator->is_segment_remap)
+        column = 127 - x;
+
+    uint8_t com = y;
+    if (emulator->is_scan_remap)
+        com = emulator->mux_ratio - y;
+    uint8_t row = (com + emulator->start_line + emulator->display_offset) & 63;
+
+    bool is_on = (emulator->gddram[((row >> 3) * 128) + column] >> (row & 7)) &
+                 0x01;
+    return is_on != emulator->is_inverse;
+}
+
+/**
+ * @brief Compares the GDDRAM of the emulator with the buffer of the display.
+ *
+ * @param emulator Pointer to the ssd1306_emulator structure.
+ * @param display Pointer to the ssd1306_display structure.
+ * @return 'true' if the display holds the buffer contents; 'false' otherwise.
+ */
+bool ssd1306_emulator_compare(struct ssd1306_emulator *emulator,
+                              struct ssd1306_display *display) {
+    size_t size = 512;
+    if (ssd1306_get_display_type(display))
+        size = 1024;
+
+    /* Skip the 2 byte header of the buffer */
+    return memcmp(emulator->gddram, sd1306_get_buffer(display) + 2, size) == 0;
+}
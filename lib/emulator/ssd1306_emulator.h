@@ -0,0 +1,155 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2024 Ahmet Burak Irmak (https://youtube.com/Microesque)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Library GitHub Page:   https://github.com/Microesque/SSD1306
+ * Library Documentation: https://github.com/Microesque/SSD1306/wiki
+ */
+
+#ifndef SSD1306_EMULATOR_H
+#define SSD1306_EMULATOR_H
+
+/*----------------------------------------------------------------------------*/
+/*---------------------------- Necessary Libraries ---------------------------*/
+/*----------------------------------------------------------------------------*/
+
+#include "../ssd1306.h"
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------ Emulator Setup ------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Addressing modes of the emulated display (data-sheet p34).
+ */
+enum ssd1306_emulator_addressing_mode {
+    SSD1306_EMULATOR_ADDRESSING_HORIZONTAL,
+    SSD1306_EMULATOR_ADDRESSING_VERTICAL,
+    SSD1306_EMULATOR_ADDRESSING_PAGE
+};
+
+/*
+ * Structure representing an emulated SSD1306 controller. Initialize with
+ * ssd1306_emulator_init().
+ *
+ * The GDDRAM uses the same page-major layout as the library buffer, so the
+ * display contents can be compared to the buffer with memcmp().
+ */
+struct ssd1306_emulator {
+    /* Virtual display memory, 8 pages of 128 columns */
+    uint8_t gddram[8 * 128];
+
+    /* Bus statistics */
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t cmd_transactions;
+    uint32_t cmd_bytes;
+    uint32_t data_transactions;
+    uint32_t data_bytes;
+
+    /* Wrong addresses, unknown commands, empty transactions */
+    uint32_t protocol_errors;
+    /* Data bytes written while a scroll was active (corrupts the display) */
+    uint32_t scroll_writes;
+
+    /* Address pointer */
+    enum ssd1306_emulator_addressing_mode addressing_mode;
+    uint8_t column;
+    uint8_t page;
+    uint8_t column_start;
+    uint8_t column_end;
+    uint8_t page_start;
+    uint8_t page_end;
+    uint8_t page_mode_column_start;
+
+    /* Registers */
+    uint8_t contrast;
+    uint8_t mux_ratio;
+    uint8_t display_offset;
+    uint8_t start_line;
+    uint8_t com_configuration;
+    uint8_t div_ratio_and_freq;
+    uint8_t precharge_period;
+    uint8_t vcomh_level;
+    uint8_t charge_pump;
+    uint8_t vertical_scroll_top;
+    uint8_t vertical_scroll_rows;
+    bool is_display_on;
+    bool is_entire_display_on;
+    bool is_inverse;
+    bool is_segment_remap;
+    bool is_scan_remap;
+
+    /* Scroll setup */
+    bool is_scrolling;
+    uint8_t scroll_cmd;
+    uint8_t scroll_page_start;
+    uint8_t scroll_page_end;
+    uint8_t scroll_interval;
+    uint8_t scroll_vertical_offset;
+
+    /* Command parser, commands may continue over multiple transactions */
+    uint8_t cmd[8];
+    uint8_t cmd_length;
+    uint8_t cmd_expected;
+
+    /* Panel and bus setup */
+    enum ssd1306_display_type display_type;
+    uint8_t i2c_address;
+};
+
+/*----------------------------------------------------------------------------*/
+/*--------------------------- Available Transports ---------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Transports that feed an emulator instead of a bus. Pass the emulator as the
+ * context of ssd1306_init_transport().
+ */
+extern const struct ssd1306_transport ssd1306_emulator_transport_i2c;
+extern const struct ssd1306_transport ssd1306_emulator_transport_spi;
+
+/*----------------------------------------------------------------------------*/
+/*---------------------------- Available Functions ---------------------------*/
+/*----------------------------------------------------------------------------*/
+
+void ssd1306_emulator_init(struct ssd1306_emulator *emulator,
+                           enum ssd1306_display_type display_type,
+                           uint8_t i2c_address);
+void ssd1306_emulator_reset(struct ssd1306_emulator *emulator);
+void ssd1306_emulator_reset_stats(struct ssd1306_emulator *emulator);
+
+void ssd1306_emulator_i2c_write(struct ssd1306_emulator *emulator,
+                                const uint8_t *data, uint16_t length);
+void ssd1306_emulator_spi_write(struct ssd1306_emulator *emulator,
+                                const uint8_t *data, uint16_t length,
+                                bool is_data);
+
+const uint8_t *ssd1306_emulator_get_gddram(struct ssd1306_emulator *emulator);
+bool ssd1306_emulator_get_pixel(struct ssd1306_emulator *emulator, uint8_t x,
+                                uint8_t y);
+bool ssd1306_emulator_compare(struct ssd1306_emulator *emulator,
+                              struct ssd1306_display *display);
+
+#endif
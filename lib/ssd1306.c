@@ -34,6 +34,13 @@
 #include "ssd1306.h"
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
+
+#if SSD1306_SIMD == true && defined(__SSE2__)
+#include <emmintrin.h>
+#elif SSD1306_SIMD == true && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 /*----------------------------------------------------------------------------*/
 /*-------------------------- SSD1306 Address Macros --------------------------*/
@@ -73,8 +80,8 @@
 /*----------------------- Library Enums/Macros/Globals -----------------------*/
 /*----------------------------------------------------------------------------*/
 
-#define SSD1306_BUFFER_SIZE_32 (SSD1306_ARRAY_SIZE_32 - 2)
-#define SSD1306_BUFFER_SIZE_64 (SSD1306_ARRAY_SIZE_64 - 2)
+#define SSD1306_BUFFER_SIZE_32 512
+#define SSD1306_BUFFER_SIZE_64 1024
 
 enum ssd1303_page_offsets {
     SSD1306_PAGE0_OFFSET = 0,
@@ -86,141 +93,3420 @@ enum ssd1303_page_offsets {
     SSD1306_PAGE6_OFFSET = 768,
     SSD1306_PAGE7_OFFSET = 896
 };
+/*
+ * Length of the command that sets the column/page address window.
+ */
+#define SSD1306_WINDOW_CMD_LENGTH 6
+
+/*
+ * Value of ssd1306_display.window_page when the window command of the current
+ * window hasn't been sent yet.
+ */
+#define SSD1306_WINDOW_PAGE_CMD 0xFF
+
 static const uint16_t SSD1306_PAGE_OFFSETS[] = {
     SSD1306_PAGE0_OFFSET, SSD1306_PAGE1_OFFSET, SSD1306_PAGE2_OFFSET,
     SSD1306_PAGE3_OFFSET, SSD1306_PAGE4_OFFSET, SSD1306_PAGE5_OFFSET,
     SSD1306_PAGE6_OFFSET, SSD1306_PAGE7_OFFSET};
 
+/*
+ * Rows of a glyph column magnified by 2, 3 and 4, 4 rows (a nibble) at a time.
+ * Row 'i' of the nibble becomes rows [i * scale...i * scale + scale - 1].
+ */
+static const uint16_t SSD1306_NIBBLE_SCALES[3][16] = {
+    {0x0000, 0x0003, 0x000C, 0x000F, 0x0030, 0x0033, 0x003C, 0x003F,
+     0x00C0, 0x00C3, 0x00CC, 0x00CF, 0x00F0, 0x00F3, 0x00FC, 0x00FF},
+    {0x0000, 0x0007, 0x0038, 0x003F, 0x01C0, 0x01C7, 0x01F8, 0x01FF,
+     0x0E00, 0x0E07, 0x0E38, 0x0E3F, 0x0FC0, 0x0FC7, 0x0FF8, 0x0FFF},
+    {0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF,
+     0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF}};
+
+/*
+ * Bytes with their bits in reverse order, flips 8 rows of a column vertically.
+ */
+static const uint8_t SSD1306_REVERSED_BYTES[256] = {
+    0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0, 0x10, 0x90, 0x50, 0xD0,
+    0x30, 0xB0, 0x70, 0xF0, 0x08, 0x88, 0x48, 0xC8, 0x28, 0xA8, 0x68, 0xE8,
+    0x18, 0x98, 0x58, 0xD8, 0x38, 0xB8, 0x78, 0xF8, 0x04, 0x84, 0x44, 0xC4,
+    0x24, 0xA4, 0x64, 0xE4, 0x14, 0x94, 0x54, 0xD4, 0x34, 0xB4, 0x74, 0xF4,
+    0x0C, 0x8C, 0x4C, 0xCC, 0x2C, 0xAC, 0x6C, 0xEC, 0x1C, 0x9C, 0x5C, 0xDC,
+    0x3C, 0xBC, 0x7C, 0xFC, 0x02, 0x82, 0x42, 0xC2, 0x22, 0xA2, 0x62, 0xE2,
+    0x12, 0x92, 0x52, 0xD2, 0x32, 0xB2, 0x72, 0xF2, 0x0A, 0x8A, 0x4A, 0xCA,
+    0x2A, 0xAA, 0x6A, 0xEA, 0x1A, 0x9A, 0x5A, 0xDA, 0x3A, 0xBA, 0x7A, 0xFA,
+    0x06, 0x86, 0x46, 0xC6, 0x26, 0xA6, 0x66, 0xE6, 0x16, 0x96, 0x56, 0xD6,
+    0x36, 0xB6, 0x76, 0xF6, 0x0E, 0x8E, 0x4E, 0xCE, 0x2E, 0xAE, 0x6E, 0xEE,
+    0x1E, 0x9E, 0x5E, 0xDE, 0x3E, 0xBE, 0x7E, 0xFE, 0x01, 0x81, 0x41, 0xC1,
+    0x21, 0xA1, 0x61, 0xE1, 0x11, 0x91, 0x51, 0xD1, 0x31, 0xB1, 0x71, 0xF1,
+    0x09, 0x89, 0x49, 0xC9, 0x29, 0xA9, 0x69, 0xE9, 0x19, 0x99, 0x59, 0xD9,
+    0x39, 0xB9, 0x79, 0xF9, 0x05, 0x85, 0x45, 0xC5, 0x25, 0xA5, 0x65, 0xE5,
+    0x15, 0x95, 0x55, 0xD5, 0x35, 0xB5, 0x75, 0xF5, 0x0D, 0x8D, 0x4D, 0xCD,
+    0x2D, 0xAD, 0x6D, 0xED, 0x1D, 0x9D, 0x5D, 0xDD, 0x3D, 0xBD, 0x7D, 0xFD,
+    0x03, 0x83, 0x43, 0xC3, 0x23, 0xA3, 0x63, 0xE3, 0x13, 0x93, 0x53, 0xD3,
+    0x33, 0xB3, 0x73, 0xF3, 0x0B, 0x8B, 0x4B, 0xCB, 0x2B, 0xAB, 0x6B, 0xEB,
+    0x1B, 0x9B, 0x5B, 0xDB, 0x3B, 0xBB, 0x7B, 0xFB, 0x07, 0x87, 0x47, 0xC7,
+    0x27, 0xA7, 0x67, 0xE7, 0x17, 0x97, 0x57, 0xD7, 0x37, 0xB7, 0x77, 0xF7,
+    0x0F, 0x8F, 0x4F, 0xCF, 0x2F, 0xAF, 0x6F, 0xEF, 0x1F, 0x9F, 0x5F, 0xDF,
+    0x3F, 0xBF, 0x7F, 0xFF};
+
+/*
+ * Edge of a filled shape, stepped one row at a time without divisions. The
+ * x-coordinate is the same as 'x0 + (y - y0) * dx / dy' with C's truncating
+ * division.
+ */
+struct ssd1306_edge {
+    int32_t x;
+    int32_t step;
+    int32_t error;
+    int32_t error_step;
+    int32_t dy;
+    int8_t dir;
+};
+
+/*
+ * Spans of the rows of one page, collected as per-column toggles of the row
+ * bits so that the page is written with a single pass. Used by the fills that
+ * produce several spans per page (polygons, circles, etc.).
+ */
+struct ssd1306_band {
+    uint8_t toggles[SSD1306_X_MAX + 2];
+    int16_t x_min;
+    int16_t x_max;
+    int16_t solid_min;
+    int16_t solid_max;
+    int16_t row;
+    bool is_solid;
+};
+
+/*
+ * Entry of the polygon edge table. Horizontal edges have a winding of 0 and
+ * are drawn as a span on their row.
+ */
+struct ssd1306_polygon_edge {
+    struct ssd1306_edge edge;
+    int16_t x_top;
+    int16_t y_top;
+    int16_t x_bottom;
+    int16_t y_bottom;
+    int16_t y_last;
+    int8_t winding;
+};
+
+#if SSD1306_GLYPH_CACHE_COUNT > 0
+/*
+ * Font glyph cached in the page-major layout of the display. Byte
+ * 'page * width + x' holds rows [page * 8...page * 8 + 7] of column 'x', with
+ * the top row in the LSB.
+ */
+struct ssd1306_cached_glyph {
+    const uint8_t *bitmap;
+    uint8_t width;
+    uint8_t height;
+    uint16_t last_use;
+    uint8_t columns[SSD1306_GLYPH_CACHE_SLOT_SIZE];
+};
+#endif
+
 /*----------------------------------------------------------------------------*/
 /*----------------------------- Helper Functions -----------------------------*/
 /*----------------------------------------------------------------------------*/
 
 /**
- * @brief Sends the command buffer to the display.
+ * @brief Waits until the ongoing asynchronous transfer (if any) is complete.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+static void h_wait_idle(struct ssd1306_display *display) {
+#if SSD1306_ASYNC_TRANSFER == true
+    while (display->is_busy) {
+    }
+#else
+    (void)display;
+#endif
+}
+
+/**
+ * @brief Sends the specified commands to the display in a single transaction.
+ *
+ * @note
+ * - With SSD1306_ASYNC_TRANSFER, waits for the ongoing transfer first, then
+ * waits for the commands themselves to complete, so that the command memory
+ * can be reused as soon as this function returns.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param cmd Pointer to the commands (inside ssd1306_display.cmd_memory[]).
+ * @param length The number of bytes to send.
+ */
+static void h_write_cmd(struct ssd1306_display *display, uint8_t *cmd,
+                        uint8_t length) {
+    h_wait_idle(display);
+#if SSD1306_ASYNC_TRANSFER == true
+    display->is_busy = true;
+    display->transport->write_cmd(display, cmd, length);
+    h_wait_idle(display);
+#else
+    display->transport->write_cmd(display, cmd, length);
+#endif
+}
+
+/**
+ * @brief Sends the batched commands (if any) and resets the batch.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+static void h_flush_cmd_batch(struct ssd1306_display *display) {
+    if (display->cmd_batch_length) {
+        h_write_cmd(display, &display->cmd_memory[2],
+                    display->cmd_batch_length);
+        display->cmd_batch_length = 0;
+    }
+    display->cmd_buffer = &display->cmd_memory[2];
+}
+
+/**
+ * @brief Sends the command buffer to the display.
+ *
+ * @note
+ * - During a batch (ssd1306_display_batch_begin()), the commands are appended
+ * to the batch instead, and the command buffer moves past them. The batch is
+ * sent early if there's no room left for another command.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param length The number of bytes to send. Maximum 8 commands (not checked)!
+ */
+static void h_send_cmd_buffer(struct ssd1306_display *display, uint8_t length) {
+    if (!display->is_cmd_batch) {
+        h_write_cmd(display, display->cmd_buffer, length);
+        return;
+    }
+
+    display->cmd_batch_length += length;
+    display->cmd_buffer += length;
+    if (SSD1306_CMD_BATCH_LIMIT - display->cmd_batch_length < 8)
+        h_flush_cmd_batch(display);
+}
+
+/**
+ * @brief Checks if the specified window covers the entire display.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param window Pointer to the window.
+ * @return 'true' if the window covers the entire display; 'false' otherwise.
+ */
+static bool h_is_window_full(struct ssd1306_display *display,
+                             const struct ssd1306_window *window) {
+    uint8_t page_last;
+    if (display->display_type)
+        page_last = 7;
+    else
+        page_last = 3;
+
+    return (window->x_min == 0) && (window->x_max == SSD1306_X_MAX) &&
+           (window->page_min == 0) && (window->page_max == page_last);
+}
+
+/**
+ * @brief Sets the column/page address window of the display. Subsequent data
+ * is written starting from the top-left corner of the window.
+ *
+ * @note
+ * - Uses its own memory instead of the command buffer, since it's part of a
+ * frame transfer which may still be ongoing when the user sends commands.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param window Pointer to the window.
+ */
+static void h_send_window(struct ssd1306_display *display,
+                          const struct ssd1306_window *window) {
+    uint8_t *window_memory = display->window_memory;
+    window_memory[2] = SSD1306_CMD_SET_COLUMN_ADDRESS;
+    window_memory[3] = window->x_min;
+    window_memory[4] = window->x_max;
+    window_memory[5] = SSD1306_CMD_SET_PAGE_ADDRESS;
+    window_memory[6] = window->page_min;
+    window_memory[7] = window->page_max;
+    display->is_window_full = h_is_window_full(display, window);
+
+#if SSD1306_ASYNC_TRANSFER == true
+    display->is_busy = true;
+#endif
+    display->transport->write_cmd(display, &window_memory[2],
+                                  SSD1306_WINDOW_CMD_LENGTH);
+}
+
+/**
+ * @brief Ends the data transaction started by h_send_data_span(). Restores the
+ * bytes that the transport may have overwritten with its header.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+static void h_end_data_span(struct ssd1306_display *display) {
+    uint16_t index = display->span_index;
+    uint16_t length = display->span_length;
+    if (length == 0)
+        return;
+    display->span_length = 0;
+
+    /* The two bytes before index 0 are reserved for the header anyway */
+    if (index != 0) {
+        display->tx_buffer[index - 2] = display->span_header[0];
+        display->tx_buffer[index - 1] = display->span_header[1];
+    }
+
+#if SSD1306_SHADOW_BUFFER == true && SSD1306_ASYNC_TRANSFER == false
+    for (uint16_t i = index; i < index + length; i++) {
+        display->shadow_buffer[i] = display->tx_buffer[i];
+    }
+#endif
+}
+
+/**
+ * @brief Sends a continuous part of the transmit buffer to the display.
+ *
+ * @note
+ * - The transport may overwrite the two bytes preceding the part with its
+ * header (I2C), so that the part can be sent without copying. They are
+ * restored by h_end_data_span().
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param index Index of the first byte in the transmit buffer.
+ * @param length The number of bytes to send.
+ */
+static void h_send_data_span(struct ssd1306_display *display, uint16_t index,
+                             uint16_t length) {
+    uint8_t *header = display->tx_buffer + index - 2;
+    display->span_index = index;
+    display->span_length = length;
+    display->span_header[0] = header[0];
+    display->span_header[1] = header[1];
+
+#if SSD1306_ASYNC_TRANSFER == true
+    display->is_busy = true;
+    display->transport->write_data(display, header + 2, length);
+#else
+    display->transport->write_data(display, header + 2, length);
+    h_end_data_span(display);
+#endif
+}
+
+/**
+ * @brief Starts the next transaction (window command or data) of the queued
+ * windows.
+ *
+ * @note
+ * - Data longer than the byte limit is split into multiple transactions. The
+ * address pointer of the display simply continues where it was left.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param max_bytes Maximum number of bytes the transaction can take.
+ * @return Number of bytes of the started transaction; 0 if all queued windows
+ * have been sent, or if the next transaction doesn't fit in the byte limit.
+ */
+static uint16_t h_transfer_next(struct ssd1306_display *display,
+                                uint16_t max_bytes) {
+    if (display->window_index >= display->window_count)
+        return 0;
+
+    const struct ssd1306_window *window;
+    window = &display->windows[display->window_index];
+    uint8_t overhead = display->transport->overhead;
+    uint8_t page = display->window_page;
+    if (page == SSD1306_WINDOW_PAGE_CMD) {
+        /* After a full write, the address pointer wraps back to the origin */
+        if (!display->is_window_full || !h_is_window_full(display, window)) {
+            if (max_bytes < overhead + SSD1306_WINDOW_CMD_LENGTH)
+                return 0;
+            display->window_page = window->page_min;
+            h_send_window(display, window);
+            return overhead + SSD1306_WINDOW_CMD_LENGTH;
+        }
+        display->window_page = window->page_min;
+        page = window->page_min;
+    }
+    if (max_bytes < overhead + 1)
+        return 0;
+
+    uint16_t index = SSD1306_PAGE_OFFSETS[page] + window->x_min;
+    uint16_t length = window->x_max - window->x_min + 1;
+    if (length == SSD1306_X_MAX + 1) {
+        /* Full width rows are continuous in the buffer */
+        length *= (window->page_max - page + 1);
+        page = window->page_max;
+    }
+    index += display->window_offset;
+    length -= display->window_offset;
+
+    if (length > max_bytes - overhead) {
+        /* Mid-window, the address pointer isn't at the origin anymore */
+        length = max_bytes - overhead;
+        display->window_offset += length;
+        display->is_window_full = false;
+    } else if (page == window->page_max) {
+        display->window_offset = 0;
+        display->window_index++;
+        display->window_page = SSD1306_WINDOW_PAGE_CMD;
+        display->is_window_full = h_is_window_full(display, window);
+#if SSD1306_SHADOW_BUFFER == true
+        /* The display contents are known after a full write */
+        if (display->is_window_full)
+            display->is_shadow_valid = true;
+#endif
+    } else {
+        display->window_offset = 0;
+        display->window_page = page + 1;
+    }
+    h_send_data_span(display, index, length);
+    return length + overhead;
+}
+
+/**
+ * @brief Returns the number of bus bytes needed to send the specified window.
+ *
+ * @note
+ * - Rows of a window narrower than the display are not continuous in the
+ * buffer, so each row is sent as a separate data transaction.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param window Pointer to the window.
+ * @return Number of bytes, including the window command transaction.
+ */
+static uint16_t h_get_window_cost(struct ssd1306_display *display,
+                                  const struct ssd1306_window *window) {
+    uint8_t overhead = display->transport->overhead;
+    uint16_t width = window->x_max - window->x_min + 1;
+    uint16_t rows = window->page_max - window->page_min + 1;
+    uint16_t cost = overhead + SSD1306_WINDOW_CMD_LENGTH;
+    if (display->is_window_full && h_is_window_full(display, window))
+        cost = 0;
+
+    if (width == SSD1306_X_MAX + 1)
+        return cost + overhead + (width * rows);
+    return cost + ((width + overhead) * rows);
+}
+
+/**
+ * @brief Adds a window to the queue of the next transfer.
+ *
+ * @note
+ * - If the queue is full, the last window is grown to also cover the new one.
+ * This sends some unmodified bytes, but never misses a modified one.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x_min First column of the window.
+ * @param x_max Last column of the window.
+ * @param page_min First page of the window.
+ * @param page_max Last page of the window.
+ */
+static void h_queue_window(struct ssd1306_display *display, uint8_t x_min,
+                           uint8_t x_max, uint8_t page_min, uint8_t page_max) {
+    struct ssd1306_window *window;
+    if (display->window_count == SSD1306_WINDOW_LIMIT) {
+        window = &display->windows[SSD1306_WINDOW_LIMIT - 1];
+        if (x_min < window->x_min)
+            window->x_min = x_min;
+        if (x_max > window->x_max)
+            window->x_max = x_max;
+        if (page_min < window->page_min)
+            window->page_min = page_min;
+        if (page_max > window->page_max)
+            window->page_max = page_max;
+        return;
+    }
+
+    window = &display->windows[display->window_count++];
+    window->x_min = x_min;
+    window->x_max = x_max;
+    window->page_min = page_min;
+    window->page_max = page_max;
+}
+
+/**
+ * @brief Queues the entire buffer.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+static void h_queue_full(struct ssd1306_display *display) {
+    uint8_t page_last;
+    if (display->display_type)
+        page_last = 7;
+    else
+        page_last = 3;
+
+    display->window_count = 0;
+    h_queue_window(display, 0, SSD1306_X_MAX, 0, page_last);
+}
+
+/**
+ * @brief Queues the dirty columns of each page.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+static void h_queue_dirty(struct ssd1306_display *display) {
+    uint8_t page_last;
+    if (display->display_type)
+        page_last = 7;
+    else
+        page_last = 3;
+
+    for (uint8_t page = 0; page <= page_last; page++) {
+        if (display->dirty_x_min[page] > display->dirty_x_max[page])
+            continue;
+        h_queue_window(display, display->dirty_x_min[page],
+                       display->dirty_x_max[page], page, page);
+    }
+}
+
+#if SSD1306_SHADOW_BUFFER == true
+/**
+ * @brief Compares the dirty columns against the shadow buffer and queues only
+ * the ones that changed.
+ *
+ * @note
+ * - Changed runs within a page are merged when the gap between them is cheaper
+ * to send than a new window. A page with a single run is merged with the
+ * window of the page above when the combined window is cheaper.
+ *
+ * - If the display contents are unknown, queues the entire buffer instead.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+static void h_queue_diff(struct ssd1306_display *display) {
+    if (!display->is_shadow_valid) {
+        h_queue_full(display);
+        return;
+    }
+
+    uint8_t page_last;
+    if (display->display_type)
+        page_last = 7;
+    else
+        page_last = 3;
+
+    /* A gap is merged if it's cheaper than a new window command and header */
+    uint8_t gap_max = (display->transport->overhead * 2) +
+                      SSD1306_WINDOW_CMD_LENGTH;
+
+    bool has_window = false;
+    struct ssd1306_window win, run, merged;
+    uint8_t run_count;
+    uint8_t *data_ptr;
+    uint8_t *shadow_ptr;
+    for (uint8_t page = 0; page <= page_last; page++) {
+        data_ptr = &display->data_buffer[SSD1306_PAGE_OFFSETS[page]];
+        shadow_ptr = &display->shadow_buffer[SSD1306_PAGE_OFFSETS[page]];
+        run.page_min = page;
+        run.page_max = page;
+
+        /* Find the changed runs, merge the ones with small gaps */
+        run_count = 0;
+        for (uint8_t x = display->dirty_x_min[page];
+             x <= display->dirty_x_max[page]; x++) {
+            if (data_ptr[x] == shadow_ptr[x])
+                continue;
+
+            if (run_count && (x - run.x_max - 1) <= gap_max) {
+                run.x_max = x;
+                continue;
+            }
+
+            /* A new run starts, the previous run can't grow anymore */
+            if (run_count) {
+                if (has_window) {
+                    h_queue_window(display, win.x_min, win.x_max, win.page_min,
+                                   win.page_max);
+                    has_window = false;
+                }
+                h_queue_window(display, run.x_min, run.x_max, page, page);
+            }
+            run.x_min = x;
+            run.x_max = x;
+            run_count++;
+        }
+
+        /* Try to merge the last run of the page with the window above */
+        if (run_count == 0)
+            continue;
+
+        if (has_window && run_count == 1 && win.page_max == page - 1) {
+            merged = win;
+            merged.page_max = page;
+            if (run.x_min < merged.x_min)
+                merged.x_min = run.x_min;
+            if (run.x_max > merged.x_max)
+                merged.x_max = run.x_max;
+            if (h_get_window_cost(display, &merged) <=
+                h_get_window_cost(display, &win) +
+                    h_get_window_cost(display, &run)) {
+                win = merged;
+                continue;
+            }
+        }
+
+        if (has_window)
+            h_queue_window(display, win.x_min, win.x_max, win.page_min,
+                           win.page_max);
+        has_window = true;
+        win = run;
+    }
+
+    if (has_window)
+        h_queue_window(display, win.x_min, win.x_max, win.page_min,
+                       win.page_max);
+}
+#endif
+
+#if SSD1306_ASYNC_TRANSFER == true
+/**
+ * @brief Copies the queued windows from the data buffer to the transmit
+ * buffer, so that drawing can continue while they're being sent.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+static void h_copy_queue(struct ssd1306_display *display) {
+    const struct ssd1306_window *window;
+    uint16_t index;
+    for (uint8_t i = 0; i < display->window_count; i++) {
+        window = &display->windows[i];
+        for (uint8_t page = window->page_min; page <= window->page_max;
+             page++) {
+            index = SSD1306_PAGE_OFFSETS[page];
+            for (uint8_t x = window->x_min; x <= window->x_max; x++) {
+                display->tx_buffer[index + x] = display->data_buffer[index + x];
+            }
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Marks the specified columns of a page as modified, so that the next
+ * update in dirty mode sends them.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param page Page of the columns.
+ * @param x_min First modified column.
+ * @param x_max Last modified column.
+ */
+static void h_set_dirty(struct ssd1306_display *display, uint8_t page,
+                        uint8_t x_min, uint8_t x_max) {
+    if (x_min < display->dirty_x_min[page])
+        display->dirty_x_min[page] = x_min;
+    if (x_max > display->dirty_x_max[page])
+        display->dirty_x_max[page] = x_max;
+}
+
+/**
+ * @brief Marks the entire buffer as modified.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+static void h_set_dirty_all(struct ssd1306_display *display) {
+    for (uint8_t page = 0; page < 8; page++) {
+        display->dirty_x_min[page] = 0;
+        display->dirty_x_max[page] = SSD1306_X_MAX;
+    }
+}
+
+/**
+ * @brief Marks the display contents as unknown. The next update will send the
+ * entire buffer regardless of the update mode.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+static void h_set_display_unknown(struct ssd1306_display *display) {
+    h_set_dirty_all(display);
+#if SSD1306_SHADOW_BUFFER == true
+    display->is_shadow_valid = false;
+#endif
+}
+
+/**
+ * @brief Marks the entire buffer as unmodified (min > max for every page).
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+static void h_clear_dirty_all(struct ssd1306_display *display) {
+    for (uint8_t page = 0; page < 8; page++) {
+        display->dirty_x_min[page] = 0xFF;
+        display->dirty_x_max[page] = 0x00;
+    }
+}
+
+/**
+ * @brief Queues the windows of the next update based on the update mode, and
+ * updates the statistics.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+static void h_queue_update(struct ssd1306_display *display) {
+    /* Parts of an unfinished update are sent again with this one */
+    const struct ssd1306_window *window;
+    for (uint8_t i = display->window_index; i < display->window_count; i++) {
+        window = &display->windows[i];
+        for (uint8_t page = window->page_min; page <= window->page_max;
+             page++) {
+            h_set_dirty(display, page, window->x_min, window->x_max);
+        }
+    }
+
+    display->window_count = 0;
+    display->window_index = 0;
+    display->window_page = SSD1306_WINDOW_PAGE_CMD;
+    display->window_offset = 0;
+    if (display->update_mode == SSD1306_UPDATE_MODE_FULL)
+        h_queue_full(display);
+#if SSD1306_SHADOW_BUFFER == true
+    else if (display->update_mode == SSD1306_UPDATE_MODE_DIFF)
+        h_queue_diff(display);
+#endif
+    else
+        h_queue_dirty(display);
+    h_clear_dirty_all(display);
+
+    /* Fall back to a full update if it's cheaper */
+    struct ssd1306_window window_full;
+    window_full.x_min = 0;
+    window_full.x_max = SSD1306_X_MAX;
+    window_full.page_min = 0;
+    if (display->display_type)
+        window_full.page_max = 7;
+    else
+        window_full.page_max = 3;
+    uint16_t cost_full = h_get_window_cost(display, &window_full);
+
+    uint16_t cost = 0;
+    for (uint8_t i = 0; i < display->window_count; i++) {
+        cost += h_get_window_cost(display, &display->windows[i]);
+    }
+    if (cost >= cost_full) {
+        h_queue_full(display);
+        cost = cost_full;
+    }
+
+    display->update_bytes_sent = cost;
+    if (display->display_type)
+        cost_full = display->transport->overhead + SSD1306_BUFFER_SIZE_64;
+    else
+        cost_full = display->transport->overhead + SSD1306_BUFFER_SIZE_32;
+    if (cost < cost_full)
+        display->update_bytes_saved = cost_full - cost;
+    else
+        display->update_bytes_saved = 0;
+
+#if SSD1306_ASYNC_TRANSFER == true
+    h_copy_queue(display);
+#endif
+}
+
+/**
+ * @brief Checks it the specified point is within the drawing border for the
+ * specified display.
+ *
+ * @note
+ * Below are guaranteed:
+ *
+ * - (x > 0) and (y > 0)
+ *
+ * - (x < SSD1306_X_MAX)
+ *
+ * - (y < SSD1306_Y_MAX_32) for 128x32 displays
+ *
+ * - (y < SSD1306_Y_MAX_64) for 128x64 displays
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x x-coordinate to check.
+ * @param y y-coordinate to check.
+ * @return 'true' if within range; 'false' if out of bounds.
+ */
+static bool h_are_coords_in_border(struct ssd1306_display *display, int16_t x,
+                                   int16_t y) {
+    if ((x < display->border_x_min) || (x > display->border_x_max) ||
+        (y < display->border_y_min) || (y > display->border_y_max))
+        return false;
+
+    return true;
+}
+
+/**
+ * @brief Checks if the specified box lies entirely outside the drawing border
+ * for the specified display.
+ *
+ * @note
+ * - Used to reject shapes before rasterizing them. A 'false' result doesn't
+ * mean any of the shape's pixels are visible.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x_min x-coordinate of the left edge of the box.
+ * @param y_min y-coordinate of the top edge of the box.
+ * @param x_max x-coordinate of the right edge of the box.
+ * @param y_max y-coordinate of the bottom edge of the box.
+ * @return 'true' if the box doesn't touch the border; 'false' otherwise.
+ */
+static bool h_is_box_outside_border(struct ssd1306_display *display,
+                                    int32_t x_min, int32_t y_min, int32_t x_max,
+                                    int32_t y_max) {
+    if ((x_max < display->border_x_min) || (x_min > display->border_x_max) ||
+        (y_max < display->border_y_min) || (y_min > display->border_y_max))
+        return true;
+
+    return false;
+}
+
+/**
+ * @brief Checks if the bounding box of the specified triangle lies entirely
+ * outside the drawing border for the specified display.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x0 x-coordinate of the first point.
+ * @param y0 y-coordinate of the first point.
+ * @param x1 x-coordinate of the second point.
+ * @param y1 y-coordinate of the second point.
+ * @param x2 x-coordinate of the third point.
+ * @param y2 y-coordinate of the third point.
+ * @return 'true' if the triangle doesn't touch the border; 'false' otherwise.
+ */
+static bool h_is_triangle_outside_border(struct ssd1306_display *display,
+                                         int16_t x0, int16_t y0, int16_t x1,
+                                         int16_t y1, int16_t x2, int16_t y2) {
+    int16_t x_min = x0, x_max = x0, y_min = y0, y_max = y0;
+    if (x1 < x_min)
+        x_min = x1;
+    if (x1 > x_max)
+        x_max = x1;
+    if (x2 < x_min)
+        x_min = x2;
+    if (x2 > x_max)
+        x_max = x2;
+    if (y1 < y_min)
+        y_min = y1;
+    if (y1 > y_max)
+        y_max = y1;
+    if (y2 < y_min)
+        y_min = y2;
+    if (y2 > y_max)
+        y_max = y2;
+
+    return h_is_box_outside_border(display, x_min, y_min, x_max, y_max);
+}
+
+/**
+ * @brief Checks if the bounding box of the specified arc lies entirely outside
+ * the drawing border for the specified display.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x0 x-coordinate of the arc center.
+ * @param y0 y-coordinate of the arc center.
+ * @param r Radius of the arc.
+ * @param quadrants Quadrants of the arc, same as ssd1306_draw_arc().
+ * @return 'true' if the arc doesn't touch the border; 'false' otherwise.
+ */
+static bool h_is_arc_outside_border(struct ssd1306_display *display,
+                                    int16_t x0, int16_t y0, int16_t r,
+                                    uint8_t quadrants) {
+    int32_t x_min = x0, x_max = x0, y_min = y0, y_max = y0;
+    if (quadrants & 0b0110)
+        x_min -= r;
+    if (quadrants & 0b1001)
+        x_max += r;
+    if (quadrants & 0b0011)
+        y_min -= r;
+    if (quadrants & 0b1100)
+        y_max += r;
+
+    return h_is_box_outside_border(display, x_min, y_min, x_max, y_max);
+}
+
+/**
+ * @brief Returns the number of bytes in the buffer of the display.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @return Buffer size in bytes.
+ */
+static uint16_t h_get_buffer_size(struct ssd1306_display *display) {
+    if (display->display_type)
+        return SSD1306_BUFFER_SIZE_64;
+    return SSD1306_BUFFER_SIZE_32;
+}
+
+/**
+ * @brief Returns the y-coordinate of the bottommost row of the display.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @return SSD1306_Y_MAX_32 or SSD1306_Y_MAX_64.
+ */
+static uint8_t h_get_y_max(struct ssd1306_display *display) {
+    if (display->display_type)
+        return SSD1306_Y_MAX_64;
+    return SSD1306_Y_MAX_32;
+}
+
+/**
+ * @brief Checks if the drawing coordinates of the display are rotated into
+ * portrait.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @return 'true' for SSD1306_ROTATION_90/270; 'false' otherwise.
+ */
+static bool h_is_portrait(struct ssd1306_display *display) {
+    return (display->rotation == SSD1306_ROTATION_90) ||
+           (display->rotation == SSD1306_ROTATION_270);
+}
+
+/**
+ * @brief Maps a rectangle from the drawing coordinates onto the native
+ * coordinates of the buffer, following the rotation of the display.
+ *
+ * @note
+ * - The rectangle needs to be within the screen. It stays a rectangle, only
+ * its corners are moved (and swapped for the portrait rotations).
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x_min Pointer to the x-coordinate of the leftmost pixels.
+ * @param y_min Pointer to the y-coordinate of the topmost pixels.
+ * @param x_max Pointer to the x-coordinate of the rightmost pixels.
+ * @param y_max Pointer to the y-coordinate of the bottommost pixels.
+ */
+static void h_map_rect(struct ssd1306_display *display, int32_t *x_min,
+                       int32_t *y_min, int32_t *x_max, int32_t *y_max) {
+    int32_t x0 = *x_min, y0 = *y_min, x1 = *x_max, y1 = *y_max;
+    int32_t y_last = h_get_y_max(display);
+    switch (display->rotation) {
+    case SSD1306_ROTATION_90:
+        *x_min = SSD1306_X_MAX - y1;
+        *x_max = SSD1306_X_MAX - y0;
+        *y_min = x0;
+        *y_max = x1;
+        break;
+    case SSD1306_ROTATION_180:
+        *x_min = SSD1306_X_MAX - x1;
+        *x_max = SSD1306_X_MAX - x0;
+        *y_min = y_last - y1;
+        *y_max = y_last - y0;
+        break;
+    case SSD1306_ROTATION_270:
+        *x_min = y0;
+        *x_max = y1;
+        *y_min = y_last - x1;
+        *y_max = y_last - x0;
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Maps a point from the drawing coordinates onto the native coordinates
+ * of the buffer, same as h_map_rect().
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x Pointer to the x-coordinate of the point.
+ * @param y Pointer to the y-coordinate of the point.
+ */
+static void h_map_point(struct ssd1306_display *display, int16_t *x,
+                        int16_t *y) {
+    int32_t x_min = *x, y_min = *y, x_max = *x, y_max = *y;
+    h_map_rect(display, &x_min, &y_min, &x_max, &y_max);
+    *x = (int16_t)x_min;
+    *y = (int16_t)y_min;
+}
+
+/**
+ * @brief Writes the masked bits of consecutive bytes of the buffer, following
+ * the buffer mode (set in draw mode, cleared in clear mode, toggled in XOR
+ * mode).
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param byte_ptr Pointer to the first byte.
+ * @param count Number of bytes.
+ * @param mask Bits to write in every byte.
+ */
+static void h_write_mask(struct ssd1306_display *display, uint8_t *byte_ptr,
+                         uint16_t count, uint8_t mask) {
+    uint8_t *byte_end = byte_ptr + count;
+    if (display->buffer_mode == SSD1306_BUFFER_MODE_XOR) {
+        while (byte_ptr < byte_end)
+            *byte_ptr++ ^= mask;
+    } else if (display->buffer_mode) {
+        while (byte_ptr < byte_end)
+            *byte_ptr++ |= mask;
+    } else {
+        mask = (uint8_t)~mask;
+        while (byte_ptr < byte_end)
+            *byte_ptr++ &= mask;
+    }
+}
+
+/**
+ * @brief Gets the page of the specified row, rounded down for negative rows
+ * too (row -1 is in page -1).
+ *
+ * @param y Row, can be outside the buffer.
+ * @return Page of the row.
+ */
+static int32_t h_get_page_floor(int32_t y) {
+    if (y >= 0)
+        return y / 8;
+    return -((7 - y) / 8);
+}
+
+/**
+ * @brief Fills a rectangle of pixels that's already clipped against the draw
+ * border, mapping it onto the buffer when the display is rotated.
+ *
+ * @note
+ * - Works page by page. Pages that are fully covered are written with whole
+ * bytes, the partially covered top/bottom pages with a single bit mask.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x_min x-coordinate of the leftmost pixels.
+ * @param y_min y-coordinate of the topmost pixels.
+ * @param x_max x-coordinate of the rightmost pixels.
+ * @param y_max y-coordinate of the bottommost pixels.
+ */
+static void h_fill_area(struct ssd1306_display *display, int32_t x_min,
+                        int32_t y_min, int32_t x_max, int32_t y_max) {
+    if (display->rotation != SSD1306_ROTATION_0)
+        h_map_rect(display, &x_min, &y_min, &x_max, &y_max);
+
+    uint8_t page_min = (uint8_t)(y_min >> 3);
+    uint8_t page_max = (uint8_t)(y_max >> 3);
+    uint16_t width = (uint16_t)(x_max - x_min) + 1;
+    for (uint8_t page = page_min; page <= page_max; page++) {
+        uint8_t mask = 0xFF;
+        if (page == page_min)
+            mask &= (uint8_t)(0xFF << (y_min & 7));
+        if (page == page_max)
+            mask &= (uint8_t)(0xFF >> (7 - (y_max & 7)));
+
+        uint8_t *byte_ptr = &display->data_buffer[SSD1306_PAGE_OFFSETS[page] +
+                                                  (uint16_t)x_min];
+        if (mask == 0xFF &&
+            display->buffer_mode != SSD1306_BUFFER_MODE_XOR) {
+            uint8_t fill = 0x00;
+            if (display->buffer_mode)
+                fill = 0xFF;
+            uint8_t *byte_end = byte_ptr + width;
+            while (byte_ptr < byte_end)
+                *byte_ptr++ = fill;
+        } else {
+            h_write_mask(display, byte_ptr, width, mask);
+        }
+        h_set_dirty(display, page, (uint8_t)x_min, (uint8_t)x_max);
+    }
+}
+
+/**
+ * @brief Draws a horizontal span of pixels, clipped against the draw border.
+ *
+ * @note
+ * - The span is clipped once, and the pixels are set/cleared with a single bit
+ * mask across the contiguous column bytes of the page.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x_min x-coordinate of the leftmost pixel.
+ * @param x_max x-coordinate of the rightmost pixel.
+ * @param y y-coordinate of the span.
+ */
+static void h_draw_span_h(struct ssd1306_display *display, int32_t x_min,
+                          int32_t x_max, int32_t y) {
+    if ((y < display->border_y_min) || (y > display->border_y_max))
+        return;
+    if (x_min < display->border_x_min)
+        x_min = display->border_x_min;
+    if (x_max > display->border_x_max)
+        x_max = display->border_x_max;
+    if (x_min > x_max)
+        return;
+    if (display->rotation != SSD1306_ROTATION_0) {
+        h_fill_area(display, x_min, y, x_max, y);
+        return;
+    }
+
+    uint8_t page = (uint8_t)(y >> 3);
+    uint8_t *byte_ptr = &display->data_buffer[SSD1306_PAGE_OFFSETS[page] +
+                                              (uint16_t)x_min];
+    h_write_mask(display, byte_ptr, (uint16_t)(x_max - x_min + 1),
+                 (uint8_t)(1 << (y & 7)));
+    h_set_dirty(display, page, (uint8_t)x_min, (uint8_t)x_max);
+}
+
+/**
+ * @brief Draws a vertical span of pixels, clipped against the draw border.
+ *
+ * @note
+ * - The span is clipped once, and each page it covers takes a single byte
+ * write. Partially covered top/bottom pages are set/cleared with a bit mask.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x x-coordinate of the span.
+ * @param y_min y-coordinate of the topmost pixel.
+ * @param y_max y-coordinate of the bottommost pixel.
+ */
+static void h_draw_span_v(struct ssd1306_display *display, int32_t x,
+                          int32_t y_min, int32_t y_max) {
+    if ((x < display->border_x_min) || (x > display->border_x_max))
+        return;
+    if (y_min < display->border_y_min)
+        y_min = display->border_y_min;
+    if (y_max > display->border_y_max)
+        y_max = display->border_y_max;
+    if (y_min > y_max)
+        return;
+    if (display->rotation != SSD1306_ROTATION_0) {
+        h_fill_area(display, x, y_min, x, y_max);
+        return;
+    }
+
+    uint8_t page_min = (uint8_t)(y_min >> 3);
+    uint8_t page_max = (uint8_t)(y_max >> 3);
+    for (uint8_t page = page_min; page <= page_max; page++) {
+        uint8_t mask = 0xFF;
+        if (page == page_min)
+            mask &= (uint8_t)(0xFF << (y_min & 7));
+        if (page == page_max)
+            mask &= (uint8_t)(0xFF >> (7 - (y_max & 7)));
+
+        h_write_mask(
+            display,
+            &display->data_buffer[SSD1306_PAGE_OFFSETS[page] + (uint16_t)x],
+            1, mask);
+        h_set_dirty(display, page, (uint8_t)x, (uint8_t)x);
+    }
+}
+
+/**
+ * @brief Initializes an edge going from (x0, y0) to (x1, y1), positioned at
+ * the specified row.
+ *
+ * @note
+ * - Needs (y0 < y1). Only needs a division when the edge is initialized, the
+ * rows in between (e.g. clipped ones) are skipped over in one go.
+ *
+ * @param edge Pointer to the ssd1306_edge structure.
+ * @param x0 x-coordinate of the top point.
+ * @param y0 y-coordinate of the top point.
+ * @param x1 x-coordinate of the bottom point.
+ * @param y1 y-coordinate of the bottom point.
+ * @param y Row to start from, (y >= y0).
+ */
+static void h_init_edge(struct ssd1306_edge *edge, int32_t x0, int32_t y0,
+                        int32_t x1, int32_t y1, int32_t y) {
+    int32_t dx = x1 - x0;
+    edge->dir = 1;
+    if (dx < 0) {
+        dx = -dx;
+        edge->dir = -1;
+    }
+    edge->dy = y1 - y0;
+    edge->step = (dx / edge->dy) * edge->dir;
+    edge->error_step = dx % edge->dy;
+
+    int64_t offset = (int64_t)(y - y0) * dx;
+    edge->x = x0 + (int32_t)(offset / edge->dy) * edge->dir;
+    edge->error = (int32_t)(offset % edge->dy);
+}
+
+/**
+ * @brief Moves the edge down by one row.
+ *
+ * @param edge Pointer to the ssd1306_edge structure.
+ */
+static void h_step_edge(struct ssd1306_edge *edge) {
+    edge->x += edge->step;
+    edge->error += edge->error_step;
+    if (edge->error >= edge->dy) {
+        edge->error -= edge->dy;
+        edge->x += edge->dir;
+    }
+}
+
+/**
+ * @brief Draws the horizontal span between two x-coordinates, in any order.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param xa x-coordinate of one end of the span.
+ * @param xb x-coordinate of the other end of the span.
+ * @param y y-coordinate of the span.
+ */
+static void h_draw_span_between(struct ssd1306_display *display, int32_t xa,
+                                int32_t xb, int32_t y) {
+    if (xa < xb)
+        h_draw_span_h(display, xa, xb, y);
+    else
+        h_draw_span_h(display, xb, xa, y);
+}
+
+/**
+ * @brief Draws the outline of a polygon in XOR mode, toggling every pixel of
+ * it once even where the edges overlap (shared vertices, sharp corners, etc.).
+ *
+ * @note
+ * - Works on chunks of SSD1306_XOR_OUTLINE_CHUNK columns of a page at a time:
+ * the old contents of the chunk are saved and cleared, the edges are drawn in
+ * draw mode with the border set to the chunk, then the old contents are
+ * toggled with them.
+ *
+ * - The buffer mode and the border of the display are changed while drawing,
+ * and restored afterwards.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param points Pointer to the xy-coordinates of the vertices.
+ * @param count Number of vertices (count > 0).
+ */
+static void h_draw_outline_xor(struct ssd1306_display *display,
+                               const int16_t *points, uint8_t count) {
+    uint8_t saved[SSD1306_XOR_OUTLINE_CHUNK]; /* Old contents of the chunk */
+    int32_t x_min = points[0], y_min = points[1];
+    int32_t x_max = points[0], y_max = points[1];
+    for (uint8_t i = 1; i < count; i++) {
+        int32_t x = points[i << 1], y = points[(i << 1) + 1];
+        if (x < x_min)
+            x_min = x;
+        if (x > x_max)
+            x_max = x;
+        if (y < y_min)
+            y_min = y;
+        if (y > y_max)
+            y_max = y;
+    }
+    uint8_t border_x_min = display->border_x_min;
+    uint8_t border_y_min = display->border_y_min;
+    uint8_t border_x_max = display->border_x_max;
+    uint8_t border_y_max = display->border_y_max;
+    if (x_min < border_x_min)
+        x_min = border_x_min;
+    if (x_max > border_x_max)
+        x_max = border_x_max;
+    if (y_min < border_y_min)
+        y_min = border_y_min;
+    if (y_max > border_y_max)
+        y_max = border_y_max;
+    if ((x_min > x_max) || (y_min > y_max))
+        return;
+
+    int32_t native_x_min = x_min, native_y_min = y_min;
+    int32_t native_x_max = x_max, native_y_max = y_max;
+    h_map_rect(display, &native_x_min, &native_y_min, &native_x_max,
+               &native_y_max);
+    int32_t y_last = h_get_y_max(display);
+    bool is_x_flipped = (display->rotation == SSD1306_ROTATION_90 ||
+                         display->rotation == SSD1306_ROTATION_180);
+    bool is_y_flipped = (display->rotation == SSD1306_ROTATION_180 ||
+                         display->rotation == SSD1306_ROTATION_270);
+
+    display->buffer_mode = SSD1306_BUFFER_MODE_DRAW;
+    for (int32_t page = native_y_min / 8; page <= native_y_max / 8; page++) {
+        /* Drawing coordinates of the native rows of the page */
+        int32_t band_min = page * 8, band_max = page * 8 + 7;
+        if (is_y_flipped) {
+            band_min = y_last - (page * 8 + 7);
+            band_max = y_last - page * 8;
+        }
+        uint8_t *page_ptr =
+            &display->data_buffer[SSD1306_PAGE_OFFSETS[(uint8_t)page]];
+
+        for (int32_t column = native_x_min; column <= native_x_max;
+             column += SSD1306_XOR_OUTLINE_CHUNK) {
+            uint8_t width = SSD1306_XOR_OUTLINE_CHUNK;
+            if (native_x_max - column < width)
+                width = (uint8_t)(native_x_max - column + 1);
+
+            /* Drawing coordinates of the native columns of the chunk */
+            int32_t chunk_min = column, chunk_max = column + width - 1;
+            if (is_x_flipped) {
+                chunk_min = SSD1306_X_MAX - (column + width - 1);
+                chunk_max = SSD1306_X_MAX - column;
+            }
+            int32_t x0 = x_min, y0 = y_min, x1 = x_max, y1 = y_max;
+            if (h_is_portrait(display)) {
+                x0 = (band_min > x0) ? band_min : x0;
+                x1 = (band_max < x1) ? band_max : x1;
+                y0 = (chunk_min > y0) ? chunk_min : y0;
+                y1 = (chunk_max < y1) ? chunk_max : y1;
+            } else {
+                x0 = (chunk_min > x0) ? chunk_min : x0;
+                x1 = (chunk_max < x1) ? chunk_max : x1;
+                y0 = (band_min > y0) ? band_min : y0;
+                y1 = (band_max < y1) ? band_max : y1;
+            }
+            display->border_x_min = (uint8_t)x0;
+            display->border_y_min = (uint8_t)y0;
+            display->border_x_max = (uint8_t)x1;
+            display->border_y_max = (uint8_t)y1;
+
+            uint8_t *chunk_ptr = page_ptr + column;
+            memcpy(saved, chunk_ptr, width);
+            memset(chunk_ptr, 0x00, width);
+            int16_t x_prev = points[((count - 1) << 1)];
+            int16_t y_prev = points[((count - 1) << 1) + 1];
+            for (uint8_t i = 0; i < count; i++) {
+                ssd1306_draw_line(display, x_prev, y_prev, points[i << 1],
+                                  points[(i << 1) + 1]);
+                x_prev = points[i << 1];
+                y_prev = points[(i << 1) + 1];
+            }
+            for (uint8_t i = 0; i < width; i++)
+                chunk_ptr[i] ^= saved[i];
+        }
+    }
+
+    display->buffer_mode = SSD1306_BUFFER_MODE_XOR;
+    display->border_x_min = border_x_min;
+    display->border_y_min = border_y_min;
+    display->border_x_max = border_x_max;
+    display->border_y_max = border_y_max;
+}
+
+/**
+ * @brief Checks if the polygon continues downward past the bottom end of the
+ * specified edge, skipping horizontal edges.
+ *
+ * @note
+ * - The bottom row of such edges belongs to the next edge, so that each
+ * boundary is only crossed once per row.
+ *
+ * @param points Pointer to the xy-coordinates of the vertices.
+ * @param count Number of vertices.
+ * @param i Index of the edge, going from vertex 'i' to vertex 'i + 1'. The edge
+ * MUST not be horizontal.
+ * @return 'true' if the polygon continues downward; 'false' otherwise.
+ */
+static bool h_is_polygon_edge_continued(const int16_t *points, uint8_t count,
+                                        uint8_t i) {
+    uint8_t j = i + 1;
+    if (j == count)
+        j = 0;
+
+    /* Walk away from the bottom vertex until the polygon moves vertically */
+    bool is_forward = (points[(j << 1) + 1] > points[(i << 1) + 1]);
+    if (!is_forward)
+        j = i;
+    while (1) {
+        uint8_t k;
+        if (is_forward)
+            k = (j + 1 == count) ? 0 : j + 1;
+        else
+            k = (j == 0) ? count - 1 : j - 1;
+
+        if (points[(k << 1) + 1] != points[(j << 1) + 1])
+            return (points[(k << 1) + 1] > points[(j << 1) + 1]);
+        j = k;
+    }
+}
+
+/**
+ * @brief Starts a new band, with no spans.
+ *
+ * @param band Pointer to the ssd1306_band structure.
+ */
+static void h_reset_band(struct ssd1306_band *band) {
+    band->x_min = SSD1306_X_MAX + 1;
+    band->x_max = -1;
+    band->solid_min = 0;
+    band->solid_max = SSD1306_X_MAX;
+    band->row = -1;
+    band->is_solid = true;
+}
+
+/**
+ * @brief Initializes a band declared by a fill function. Writing the band
+ * leaves the toggles cleared, so this is only needed once per fill.
+ *
+ * @param band Pointer to the ssd1306_band structure.
+ */
+static void h_init_band(struct ssd1306_band *band) {
+    memset(band->toggles, 0, sizeof(band->toggles));
+    h_reset_band(band);
+}
+
+/**
+ * @brief Adds a horizontal span to the band, clipped against the draw border.
+ *
+ * @note
+ * - Spans of the same row MUST not overlap.
+ *
+ * - The row MUST be within the border and within the page of the band.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param band Pointer to the ssd1306_band structure.
+ * @param x_min x-coordinate of the leftmost pixel.
+ * @param x_max x-coordinate of the rightmost pixel.
+ * @param y y-coordinate of the span.
+ */
+static void h_add_band_span(struct ssd1306_display *display,
+                            struct ssd1306_band *band, int32_t x_min,
+                            int32_t x_max, int16_t y) {
+    if (display->rotation != SSD1306_ROTATION_0) {
+        h_draw_span_h(display, x_min, x_max, y);
+        return;
+    }
+    if (x_min < display->border_x_min)
+        x_min = display->border_x_min;
+    if (x_max > display->border_x_max)
+        x_max = display->border_x_max;
+    if (x_min > x_max)
+        return;
+
+    /* Toggle the row on at the first column, and off after the last one */
+    uint8_t bit = (uint8_t)(1 << (y & 7));
+    band->toggles[x_min] ^= bit;
+    band->toggles[x_max + 1] ^= bit;
+    if (x_min < band->x_min)
+        band->x_min = (int16_t)x_min;
+    if (x_max > band->x_max)
+        band->x_max = (int16_t)x_max;
+
+    /* Columns covered by the single span of every row are solid */
+    if (band->row == y)
+        band->is_solid = false;
+    band->row = y;
+    if (x_min > band->solid_min)
+        band->solid_min = (int16_t)x_min;
+    if (x_max < band->solid_max)
+        band->solid_max = (int16_t)x_max;
+}
+
+/**
+ * @brief Writes the spans of the band onto the buffer, and starts a new band.
+ *
+ * @note
+ * - The columns with toggles go through the toggles one by one. The solid
+ * columns in between have no toggles, so they're written with a constant mask.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param band Pointer to the ssd1306_band structure.
+ * @param page Page of the band.
+ */
+static void h_draw_band(struct ssd1306_display *display,
+                        struct ssd1306_band *band, uint8_t page) {
+    if (band->x_min > band->x_max) {
+        h_reset_band(band);
+        return;
+    }
+
+    uint8_t *page_ptr = &display->data_buffer[SSD1306_PAGE_OFFSETS[page]];
+    uint8_t *toggles = band->toggles;
+    uint8_t x_max = (uint8_t)band->x_max;
+    uint8_t solid_min = (uint8_t)band->solid_min;
+    uint8_t solid_max = (uint8_t)band->solid_max;
+    if (!band->is_solid || (solid_min >= solid_max))
+        solid_min = x_max;
+
+    /* The buffer mode as "(byte & ~(mask & clear)) ^ (mask & flip)" */
+    uint8_t clear = 0xFF, flip = 0x00;
+    if (display->buffer_mode == SSD1306_BUFFER_MODE_XOR) {
+        clear = 0x00;
+        flip = 0xFF;
+    } else if (display->buffer_mode) {
+        flip = 0xFF;
+    }
+
+    uint8_t x = (uint8_t)band->x_min;
+    uint8_t mask = 0;
+    while (1) {
+        uint8_t x_end = (x <= solid_min) ? solid_min : x_max;
+        for (; x <= x_end; x++) {
+            mask ^= toggles[x];
+            toggles[x] = 0;
+            page_ptr[x] = (uint8_t)((page_ptr[x] & ~(mask & clear)) ^
+                                    (mask & flip));
+        }
+        if (x > x_max)
+            break;
+
+        uint8_t keep_mask = (uint8_t)~(mask & clear);
+        uint8_t flip_mask = mask & flip;
+        for (; x <= solid_max; x++)
+            page_ptr[x] = (uint8_t)((page_ptr[x] & keep_mask) ^ flip_mask);
+    }
+    toggles[x_max + 1] = 0;
+    h_set_dirty(display, page, (uint8_t)band->x_min, x_max);
+    h_reset_band(band);
+}
+
+/**
+ * @brief Finishes a row of the band. Once the last row of the page (or of the
+ * shape) is done, the band is written onto the buffer.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param band Pointer to the ssd1306_band structure.
+ * @param y y-coordinate of the row.
+ * @param y_last y-coordinate of the last row of the shape.
+ */
+static void h_end_band_row(struct ssd1306_display *display,
+                           struct ssd1306_band *band, int16_t y,
+                           int16_t y_last) {
+    if (((y & 7) == 7) || (y == y_last))
+        h_draw_band(display, band, (uint8_t)(y >> 3));
+}
+
+/**
+ * @brief Calculates the integer square root.
+ *
+ * @param n Value to get the square root of.
+ * @return The largest integer whose square is less than or equal to 'n'.
+ */
+static uint16_t h_isqrt(uint32_t n) {
+    uint32_t root = 0;
+    uint32_t bit = (uint32_t)1 << 30;
+    while (bit > n)
+        bit >>= 2;
+    while (bit) {
+        if (n >= root + bit) {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t)root;
+}
+
+/**
+ * @brief Calculates how far a filled circle extends from its center column on
+ * the specified row.
+ *
+ * @note
+ * - A pixel (a, b) away from the center is part of a filled circle if
+ * "a^2 + b^2 - max(a, b) < r^2", which matches the midpoint algorithm used by
+ * ssd1306_draw_arc(). The rows are contiguous.
+ *
+ * @param r Radius of the circle, (r > 0).
+ * @param b Row, relative to the center row [0...r].
+ * @return Number of pixels the row extends to the left/right of the center.
+ */
+static int16_t h_get_circle_width(int16_t r, int16_t b) {
+    uint32_t k = (uint32_t)r * r - (uint32_t)b * b;
+
+    /* Widest a >= b, with a * (a - 1) < k */
+    if (k > 0) {
+        uint16_t a = h_isqrt(k);
+        if ((uint32_t)a * (a + 1) < k)
+            a++;
+        if (a >= b)
+            return a;
+    }
+
+    /* Otherwise widest a < b, with a^2 < k + b */
+    uint16_t a = h_isqrt(k + b - 1);
+    if (a > b - 1)
+        a = b - 1;
+    return a;
+}
+
+/**
+ * @brief Calculates the widths of the rows of a filled circle with the
+ * specified radius (see h_get_circle_width()).
+ *
+ * @note
+ * - The widths are calculated incrementally, without square roots.
+ *
+ * @param r Radius of the circle, (r >= 0).
+ * @param profile Pointer where the widths of rows [0...r] will be placed.
+ */
+static void h_calc_circle_profile(int16_t r, uint8_t *profile) {
+    /* The widths only shrink going away from the center row */
+    int16_t a = r;
+    for (int16_t b = 0; b <= r; b++) {
+        while ((a * a) + (b * b) - ((a > b) ? a : b) >= (r * r))
+            a--;
+        profile[b] = (uint8_t)a;
+    }
+}
+
+/**
+ * @brief Gets the widths of the rows of a filled circle with the specified
+ * radius (see h_get_circle_width()), from a small cache.
+ *
+ * @note
+ * - Without the cache (SSD1306_PROFILE_CACHE_SIZE is 0), the widths are
+ * calculated into the specified array every time.
+ *
+ * @param r Radius of the circle [1...SSD1306_PROFILE_RADIUS_MAX].
+ * @param rows Pointer to an array of "r + 1" values, used when the widths
+ * aren't cached.
+ * @return Pointer to the widths of rows [0...r].
+ */
+static const uint8_t *h_get_circle_profile(int16_t r, uint8_t *rows) {
+#if SSD1306_PROFILE_CACHE_SIZE > 0
+    static uint8_t profiles[SSD1306_PROFILE_CACHE_SIZE]
+                           [SSD1306_PROFILE_RADIUS_MAX + 1];
+    static int16_t radii[SSD1306_PROFILE_CACHE_SIZE];
+    static uint8_t next;
+
+    for (uint8_t i = 0; i < SSD1306_PROFILE_CACHE_SIZE; i++) {
+        if (radii[i] == r)
+            return profiles[i];
+    }
+
+    rows = profiles[next];
+    radii[next] = r;
+    if (++next == SSD1306_PROFILE_CACHE_SIZE)
+        next = 0;
+#endif
+    h_calc_circle_profile(r, rows);
+    return rows;
+}
+
+/**
+ * @brief Draws the points of the corners of a rounded outline, mirrored from
+ * a point of the first octant.
+ *
+ * @note
+ * - Points shared by the corners are only drawn once: those on the axes when
+ * the corners have the same center, and those next to the axes (or the
+ * opposite corner for a 2x2 box) when the centers are next to each other.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x_left x-coordinate of the left corner centers.
+ * @param y_top y-coordinate of the top corner centers.
+ * @param x_right x-coordinate of the right corner centers.
+ * @param y_bottom y-coordinate of the bottom corner centers.
+ * @param dx Horizontal offset of the point from the centers.
+ * @param dy Vertical offset of the point from the centers.
+ * @param r Radius of the corners.
+ * @param quadrants Quadrants to draw, same as ssd1306_draw_arc().
+ */
+static void h_draw_round_points(struct ssd1306_display *display,
+                                int32_t x_left, int32_t y_top, int32_t x_right,
+                                int32_t y_bottom, int16_t dx, int16_t dy,
+                                int16_t r, uint8_t quadrants) {
+    uint8_t drawn = quadrants & 0b1111;
+    bool is_x_shared = (dx == 0) && (x_left == x_right);
+    bool is_y_shared = (dy == 0) && (y_top == y_bottom);
+    if (is_x_shared && is_y_shared) {
+        /* All four corners are the same point */
+        drawn &= (uint8_t)-drawn;
+    } else if (is_x_shared) {
+        if (drawn & 0b0001)
+            drawn &= (uint8_t)~0b0010;
+        if (drawn & 0b1000)
+            drawn &= (uint8_t)~0b0100;
+    } else if (is_y_shared) {
+        if (drawn & 0b0001)
+            drawn &= (uint8_t)~0b1000;
+        if (drawn & 0b0010)
+            drawn &= (uint8_t)~0b0100;
+    }
+
+    /* Next to the axis, the points of adjacent corners swap places */
+    if ((dx == 1) && (dy == r) && (x_left == x_right + 1)) {
+        if ((drawn & 0b0011) == 0b0011)
+            drawn &= (uint8_t)~0b0011;
+        if ((drawn & 0b1100) == 0b1100)
+            drawn &= (uint8_t)~0b1100;
+    }
+    if ((dy == 1) && (dx == r) && (y_top == y_bottom + 1)) {
+        if ((drawn & 0b1001) == 0b1001)
+            drawn &= (uint8_t)~0b1001;
+        if ((drawn & 0b0110) == 0b0110)
+            drawn &= (uint8_t)~0b0110;
+    }
+    if ((dx == 1) && (dy == 0) && (r == 1) && (x_left == x_right + 1) &&
+        (y_top == y_bottom + 1))
+        drawn &= (uint8_t)~((drawn << 2) | (drawn >> 2));
+
+    if (drawn & 0b0001)
+        ssd1306_draw_pixel(display, (int16_t)(x_right + dx),
+                           (int16_t)(y_top - dy));
+    if (drawn & 0b0010)
+        ssd1306_draw_pixel(display, (int16_t)(x_left - dx),
+                           (int16_t)(y_top - dy));
+    if (drawn & 0b0100)
+        ssd1306_draw_pixel(display, (int16_t)(x_left - dx),
+                           (int16_t)(y_bottom + dy));
+    if (drawn & 0b1000)
+        ssd1306_draw_pixel(display, (int16_t)(x_right + dx),
+                           (int16_t)(y_bottom + dy));
+}
+
+/**
+ * @brief Draws the corners of a rounded outline: circle quadrants around the
+ * four specified corner centers, each pixel drawn once.
+ *
+ * @note
+ * - Only used in XOR mode, where a pixel drawn twice would be toggled back.
+ * The other modes plot the octants directly, which is faster.
+ *
+ * - Uses the midpoint circle algorithm over the first octant, the others are
+ * mirrored. A circle is an outline with all four centers at the same point.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x_left x-coordinate of the left corner centers.
+ * @param y_top y-coordinate of the top corner centers.
+ * @param x_right x-coordinate of the right corner centers.
+ * @param y_bottom y-coordinate of the bottom corner centers.
+ * @param r Radius of the corners, (r >= 0).
+ * @param quadrants Quadrants to draw, same as ssd1306_draw_arc().
+ */
+static void h_draw_round_outline(struct ssd1306_display *display,
+                                 int32_t x_left, int32_t y_top,
+                                 int32_t x_right, int32_t y_bottom, int16_t r,
+                                 uint8_t quadrants) {
+    int16_t f_middle, delta_e, delta_se, x, y;
+
+    /* Initialize the middle point and delta values, start from (0, r) */
+    f_middle = 1 - r; /* Simplified from "5/4-r" */
+    delta_e = 3;
+    delta_se = -(r + r) + 5;
+    x = 0;
+    y = r;
+
+    /* Iterate from the top of the circle to the x=y line */
+    while (x <= y) {
+        h_draw_round_points(display, x_left, y_top, x_right, y_bottom, x, y,
+                            r, quadrants);
+        if (x != y)
+            h_draw_round_points(display, x_left, y_top, x_right, y_bottom, y,
+                                x, r, quadrants);
+
+        if (f_middle < 0) {
+            f_middle += delta_e;
+            delta_se += 2;
+        } else {
+            f_middle += delta_se;
+            delta_se += 4;
+            y--;
+        }
+        delta_e += 2;
+        x++;
+    }
+}
+
+/**
+ * @brief Fills a rounded box: the rectangle between the four specified corner
+ * centers, extended by the specified radius with circle quadrants.
+ *
+ * @note
+ * - Every row is drawn once as a single span through the band, so the cost is
+ * about the area in bytes. A filled circle is a box with all four centers at
+ * the same point.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x_left x-coordinate of the left corner centers.
+ * @param y_top y-coordinate of the top corner centers.
+ * @param x_right x-coordinate of the right corner centers.
+ * @param y_bottom y-coordinate of the bottom corner centers.
+ * @param r Radius of the corners, (r >= 0).
+ * @param quadrants Quadrants to fill, same as ssd1306_draw_arc_fill().
+ */
+static void h_fill_round_box(struct ssd1306_display *display, int32_t x_left,
+                             int32_t y_top, int32_t x_right, int32_t y_bottom,
+                             int16_t r, uint8_t quadrants) {
+    struct ssd1306_band band;
+    uint8_t rows[SSD1306_PROFILE_RADIUS_MAX + 1];
+    const uint8_t *profile = NULL;
+    if ((r > 0) && (r <= SSD1306_PROFILE_RADIUS_MAX))
+        profile = h_get_circle_profile(r, rows);
+
+    int32_t y = y_top - r;
+    int32_t y_last = y_bottom + r;
+    if (y < display->border_y_min)
+        y = display->border_y_min;
+    if (y_last > display->border_y_max)
+        y_last = display->border_y_max;
+
+    h_init_band(&band);
+    for (; y <= y_last; y++) {
+        /* The top and bottom corners share a row when the box is 2r high */
+        int32_t b_top = y_top - y;
+        int32_t b_bottom = y - y_bottom;
+        int32_t b = r;
+        uint8_t left = 0;
+        uint8_t right = 0;
+        if (b_top <= 0 && b_bottom <= 0) {
+            b = 0;
+            left = quadrants & 0b0110;
+            right = quadrants & 0b1001;
+        } else {
+            if (b_top >= 0) {
+                b = b_top;
+                left |= quadrants & 0b0010;
+                right |= quadrants & 0b0001;
+            }
+            if (b_bottom >= 0) {
+                if (b_bottom < b)
+                    b = b_bottom;
+                left |= quadrants & 0b0100;
+                right |= quadrants & 0b1000;
+            }
+        }
+
+        if (left || right) {
+            int16_t width = 0;
+            if (profile)
+                width = profile[b];
+            else if (r > 0)
+                width = h_get_circle_width(r, (int16_t)b);
+
+            /* Same for the left and right corners when it's 2r wide */
+            int32_t x_min = left ? x_left - width : x_left;
+            int32_t x_max = right ? x_right + width : x_right;
+            if (x_min > x_right)
+                x_min = x_right;
+            if (x_max < x_left)
+                x_max = x_left;
+            h_add_band_span(display, &band, x_min, x_max, (int16_t)y);
+        }
+        h_end_band_row(display, &band, (int16_t)y, (int16_t)y_last);
+    }
+}
+
+/**
+ * @brief Fills a rectangle of pixels, clipped against the draw border.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x_min x-coordinate of the leftmost pixels.
+ * @param y_min y-coordinate of the topmost pixels.
+ * @param x_max x-coordinate of the rightmost pixels.
+ * @param y_max y-coordinate of the bottommost pixels.
+ */
+static void h_fill_rect(struct ssd1306_display *display, int32_t x_min,
+                        int32_t y_min, int32_t x_max, int32_t y_max) {
+    if (x_min < display->border_x_min)
+        x_min = display->border_x_min;
+    if (x_max > display->border_x_max)
+        x_max = display->border_x_max;
+    if (y_min < display->border_y_min)
+        y_min = display->border_y_min;
+    if (y_max > display->border_y_max)
+        y_max = display->border_y_max;
+    if ((x_min > x_max) || (y_min > y_max))
+        return;
+
+    h_fill_area(display, x_min, y_min, x_max, y_max);
+}
+
+/**
+ * @brief Returns the reversed version of the byte.
+ *
+ * @param byte Byte to be reversed.
+ * @return Reversed byte.
+ */
+static uint8_t h_reverse_byte(uint8_t byte) {
+    return SSD1306_REVERSED_BYTES[byte];
+}
+
+/**
+ * @brief Transposes an 8x8 block of pixels from rows into columns.
+ *
+ * @note
+ * - Bit (7 - x) of 'rows[y]' becomes bit 'y' of 'columns[x]', so row-major
+ * bytes (leftmost pixel in the MSB) turn into the page-major bytes of the
+ * display (top row in the LSB).
+ *
+ * - Swaps 1x1, 2x2 and 4x4 blocks with masks and shifts on two 32-bit words
+ * instead of moving the 64 pixels one at a time.
+ *
+ * @param rows Pointer to the 8 rows of the block.
+ * @param columns Pointer to store the 8 columns of the block.
+ */
+static void h_transpose_8x8(const uint8_t *rows, uint8_t *columns) {
+    uint32_t x = ((uint32_t)rows[7] << 24) | ((uint32_t)rows[6] << 16) |
+                 ((uint32_t)rows[5] << 8) | rows[4];
+    uint32_t y = ((uint32_t)rows[3] << 24) | ((uint32_t)rows[2] << 16) |
+                 ((uint32_t)rows[1] << 8) | rows[0];
+    uint32_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AAu;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AAu;
+    y = y ^ t ^ (t << 7);
+
+    t = (x ^ (x >> 14)) & 0x0000CCCCu;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCCu;
+    y = y ^ t ^ (t << 14);
+
+    t = (x & 0xF0F0F0F0u) | ((y >> 4) & 0x0F0F0F0Fu);
+    y = ((x << 4) & 0xF0F0F0F0u) | (y & 0x0F0F0F0Fu);
+    x = t;
+
+    columns[0] = (uint8_t)(x >> 24);
+    columns[1] = (uint8_t)(x >> 16);
+    columns[2] = (uint8_t)(x >> 8);
+    columns[3] = (uint8_t)x;
+    columns[4] = (uint8_t)(y >> 24);
+    columns[5] = (uint8_t)(y >> 16);
+    columns[6] = (uint8_t)(y >> 8);
+    columns[7] = (uint8_t)y;
+}
+
+/**
+ * @brief Gets 8 rows of a glyph column in the page-major layout of the
+ * display, from a row-major (Adafruit-GFX) glyph bitmap.
+ *
+ * @param bitmap Pointer to the bitmap array.
+ * @param width Width of the glyph.
+ * @param height Height of the glyph.
+ * @param x Column of the glyph [0...width - 1].
+ * @param page Group of 8 rows of the glyph [0...(height - 1) / 8].
+ * @return Rows [page * 8...page * 8 + 7] of the column, top row in the LSB.
+ */
+static uint8_t h_get_glyph_column(const uint8_t *bitmap, uint8_t width,
+                                  uint8_t height, uint8_t x, uint8_t page) {
+    uint16_t y = (uint16_t)page << 3;
+    uint16_t y_end = y + 8;
+    if (y_end > height)
+        y_end = height;
+
+    uint16_t position = (y * width) + x;
+    uint8_t column = 0;
+    for (uint8_t bit = 0x01; y < y_end; y++, bit <<= 1) {
+        if (bitmap[position >> 3] & (0x80 >> (position & 7)))
+            column |= bit;
+        position += width;
+    }
+    return column;
+}
+
+/**
+ * @brief Gets 8 rows of up to 8 glyph columns in the page-major layout of the
+ * display, from a row-major (Adafruit-GFX) glyph bitmap.
+ *
+ * @note
+ * - Reads each row as a byte and converts the block with a single transpose.
+ *
+ * @param bitmap Pointer to the bitmap array.
+ * @param width Width of the glyph.
+ * @param height Height of the glyph.
+ * @param x Leftmost column of the block [0...width - 1].
+ * @param page Group of 8 rows of the glyph [0...(height - 1) / 8].
+ * @param columns Pointer to store the 8 columns of the block. Columns past the
+ * width of the glyph are undefined.
+ */
+static void h_get_glyph_block(const uint8_t *bitmap, uint8_t width,
+                              uint8_t height, uint8_t x, uint8_t page,
+                              uint8_t *columns) {
+    uint16_t y = (uint16_t)page << 3;
+    uint8_t count = (width - x < 8) ? (uint8_t)(width - x) : 8;
+
+    uint8_t rows[8] = {0};
+    uint16_t position = (y * width) + x;
+    for (uint8_t i = 0; i < 8 && y + i < height; i++) {
+        /* The byte after is only read if the row continues into it */
+        uint8_t offset = position & 7;
+        uint16_t bits = (uint16_t)bitmap[position >> 3] << 8;
+        if (offset + count > 8)
+            bits |= bitmap[(position >> 3) + 1];
+        rows[i] = (uint8_t)(bits >> (8 - offset));
+        position += width;
+    }
+    h_transpose_8x8(rows, columns);
+}
+
+/**
+ * @brief Converts a row-major (Adafruit-GFX) glyph bitmap into the page-major
+ * layout of the display, 8x8 blocks at a time with h_get_glyph_block().
+ *
+ * @param bitmap Pointer to the bitmap array of the glyph.
+ * @param width Width of the glyph.
+ * @param height Height of the glyph.
+ * @param columns Pointer to store the columns (see ssd1306_cached_glyph), MUST
+ * hold "width * ((height + 7) / 8)" bytes.
+ */
+static void h_convert_glyph(const uint8_t *bitmap, uint8_t width,
+                            uint8_t height, uint8_t *columns) {
+    uint8_t pages = (uint8_t)((height + 7) >> 3);
+    for (uint8_t page = 0; page < pages; page++) {
+        for (uint16_t x = 0; x < width; x += 8) {
+            uint8_t block[8];
+            uint8_t count = (width - x < 8) ? (uint8_t)(width - x) : 8;
+            h_get_glyph_block(bitmap, width, height, (uint8_t)x, page, block);
+            memcpy(columns, block, count);
+            columns += count;
+        }
+    }
+}
+
+/**
+ * @brief Gets a font glyph in the page-major layout of the display from the
+ * glyph cache, converting and caching it first if needed.
+ *
+ * @note
+ * - Glyphs are identified by their bitmap pointer and size, so the bitmaps
+ * must not change once drawn. The least recently used glyph is replaced when
+ * the cache is full.
+ *
+ * @param bitmap Pointer to the bitmap array of the glyph.
+ * @param width Width of the glyph.
+ * @param height Height of the glyph.
+ * @return Pointer to the columns (see ssd1306_cached_glyph), or NULL if the
+ * glyph doesn't fit in a cache slot or the cache is disabled.
+ */
+static const uint8_t *h_get_cached_glyph(const uint8_t *bitmap, uint8_t width,
+                                         uint8_t height) {
+#if SSD1306_GLYPH_CACHE_COUNT > 0
+    static struct ssd1306_cached_glyph cache[SSD1306_GLYPH_CACHE_COUNT];
+    static uint16_t use_count;
+
+    uint8_t pages = (uint8_t)((height + 7) >> 3);
+    if ((uint16_t)width * pages > SSD1306_GLYPH_CACHE_SLOT_SIZE)
+        return NULL;
+
+    use_count++;
+    struct ssd1306_cached_glyph *oldest = &cache[0];
+    for (uint8_t i = 0; i < SSD1306_GLYPH_CACHE_COUNT; i++) {
+        struct ssd1306_cached_glyph *glyph = &cache[i];
+        if (glyph->bitmap == bitmap && glyph->width == width &&
+            glyph->height == height) {
+            glyph->last_use = use_count;
+            return glyph->columns;
+        }
+        if ((uint16_t)(use_count - glyph->last_use) >
+            (uint16_t)(use_count - oldest->last_use))
+            oldest = glyph;
+    }
+
+    oldest->bitmap = bitmap;
+    oldest->width = width;
+    oldest->height = height;
+    oldest->last_use = use_count;
+    h_convert_glyph(bitmap, width, height, oldest->columns);
+    return oldest->columns;
+#else
+    (void)bitmap;
+    (void)width;
+    (void)height;
+    return NULL;
+#endif
+}
+
+/**
+ * @brief Draws a glyph at its native size, 8 rows of a column at a time with
+ * shifted byte writes, clipped against the draw border.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x0 x-coordinate of the top left pixel of the glyph.
+ * @param y0 y-coordinate of the top left pixel of the glyph.
+ * @param bitmap Pointer to the row-major bitmap array of the glyph.
+ * @param columns Pointer to the page-major columns of the glyph, or NULL to
+ * read them from the bitmap.
+ * @param width Width of the glyph.
+ * @param height Height of the glyph.
+ */
+static void h_draw_glyph(struct ssd1306_display *display, int32_t x0,
+                         int32_t y0, const uint8_t *bitmap,
+                         const uint8_t *columns, uint8_t width,
+                         uint8_t height) {
+    int32_t x_min = x0;
+    int32_t x_max = x0 + width - 1;
+    if (x_min < display->border_x_min)
+        x_min = display->border_x_min;
+    if (x_max > display->border_x_max)
+        x_max = display->border_x_max;
+    if (x_min > x_max)
+        return;
+
+    uint8_t pages = (uint8_t)((height + 7) >> 3);
+    for (uint8_t page = 0; page < pages; page++) {
+        int32_t y = y0 + ((int32_t)page << 3);
+        if (y > display->border_y_max)
+            break;
+        if (y + 7 < display->border_y_min)
+            continue;
+
+        /* Rows outside the border are masked, the ones above 0 shifted out */
+        uint8_t mask = 0xFF;
+        if (y < display->border_y_min)
+            mask = (uint8_t)(mask << (display->border_y_min - y));
+        if (y + 7 > display->border_y_max)
+            mask &= (uint8_t)(0xFF >> (y + 7 - display->border_y_max));
+        uint8_t drop = 0;
+        if (y < 0) {
+            drop = (uint8_t)-y;
+            y = 0;
+        }
+
+        uint8_t target = (uint8_t)(y >> 3);
+        uint8_t shift = (uint8_t)(y & 7);
+        uint8_t *low = &display->data_buffer[SSD1306_PAGE_OFFSETS[target]];
+        uint8_t *high = low;
+        if (target < 7)
+            high = &display->data_buffer[SSD1306_PAGE_OFFSETS[target + 1]];
+
+        uint8_t low_min = SSD1306_X_MAX, low_max = 0;
+        uint8_t high_min = SSD1306_X_MAX, high_max = 0;
+        for (int32_t x = x_min; x <= x_max; x++) {
+            uint8_t bits;
+            if (columns)
+                bits = columns[(page * width) + (x - x0)];
+            else
+                bits = h_get_glyph_column(bitmap, width, height,
+                                          (uint8_t)(x - x0), page);
+            bits = (uint8_t)((bits & mask) >> drop);
+            if (bits == 0)
+                continue;
+
+            uint8_t bits_low = (uint8_t)(bits << shift);
+            uint8_t bits_high = (uint8_t)(bits >> (8 - shift));
+            if (shift == 0)
+                bits_high = 0;
+            if (bits_low) {
+                h_write_mask(display, &low[x], 1, bits_low);
+                if ((uint8_t)x < low_min)
+                    low_min = (uint8_t)x;
+                low_max = (uint8_t)x;
+            }
+            if (bits_high) {
+                h_write_mask(display, &high[x], 1, bits_high);
+                if ((uint8_t)x < high_min)
+                    high_min = (uint8_t)x;
+                high_max = (uint8_t)x;
+            }
+        }
+        if (low_min <= low_max)
+            h_set_dirty(display, target, low_min, low_max);
+        if (high_min <= high_max)
+            h_set_dirty(display, target + 1, high_min, high_max);
+    }
+}
+
+/**
+ * @brief Draws a glyph magnified by the specified scale.
+ *
+ * @note
+ * - Each glyph column is expanded into a strip of page bytes (with lookup
+ * tables for scales 2-4), and every strip byte is written to all the 'scale'
+ * display columns it covers at once. Only the pages the glyph covers are
+ * written, and each of them is marked dirty once.
+ *
+ * - Columns that fit in 64 bits once they're expanded with the tables (up to
+ * 56 rows) are built in a single integer and split into page bytes.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x0 x-coordinate of the top left pixel of the glyph.
+ * @param y0 y-coordinate of the top left pixel of the glyph.
+ * @param bitmap Pointer to the row-major bitmap array of the glyph.
+ * @param columns Pointer to the page-major columns of the glyph, or NULL to
+ * read them from the bitmap.
+ * @param width Width of the glyph.
+ * @param height Height of the glyph.
+ * @param scale Scale of the glyph, (scale > 1).
+ */
+static void h_draw_glyph_scaled(struct ssd1306_display *display, int32_t x0,
+                                int32_t y0, const uint8_t *bitmap,
+                                const uint8_t *columns, uint8_t width,
+                                uint8_t height, uint8_t scale) {
+    int32_t page_first = h_get_page_floor(y0);
+    int32_t page_last = h_get_page_floor(y0 + (int32_t)height * scale - 1);
+    uint8_t offset = (uint8_t)(y0 - page_first * 8);
+
+    /* Rows of each page that are inside the border */
+    uint8_t page_min = display->border_y_min >> 3;
+    uint8_t page_max = display->border_y_max >> 3;
+    uint8_t masks[8];
+    for (uint8_t page = page_min; page <= page_max; page++)
+        masks[page] = 0xFF;
+    masks[page_min] &= (uint8_t)(0xFF << (display->border_y_min & 7));
+    masks[page_max] &= (uint8_t)(0xFF >> (7 - (display->border_y_max & 7)));
+
+    /* Only the pages the glyph covers are written */
+    if (page_first > page_min)
+        page_min = (uint8_t)page_first;
+    if (page_last < page_max)
+        page_max = (uint8_t)page_last;
+
+    const uint16_t *nibbles = NULL;
+    if (scale <= 4)
+        nibbles = SSD1306_NIBBLE_SCALES[scale - 2];
+
+    /* Whole columns fit in 64 bits when they're expanded with the tables */
+    bool is_whole = nibbles && (offset + (uint16_t)height * scale <= 64);
+
+    uint8_t dirty_min[8], dirty_max[8];
+    for (uint8_t p = page_min; p <= page_max; p++) {
+        dirty_min[p] = SSD1306_X_MAX;
+        dirty_max[p] = 0;
+    }
+
+    uint8_t pages = (uint8_t)((height + 7) >> 3);
+    for (uint8_t w = 0; w < width; w++) {
+        int32_t x_min = x0 + ((int32_t)w * scale);
+        int32_t x_max = x_min + scale - 1;
+        if (x_min < display->border_x_min)
+            x_min = display->border_x_min;
+        if (x_max > display->border_x_max)
+            x_max = display->border_x_max;
+        if (x_min > x_max)
+            continue;
+
+        uint8_t strip[8] = {0};
+        if (columns && is_whole) {
+            uint64_t column = 0;
+            uint8_t shift = offset;
+            for (uint8_t p = 0; p < pages; p++) {
+                uint8_t bits = columns[(p * width) + w];
+                column |= (uint64_t)nibbles[bits & 0x0F] << shift;
+                shift += scale << 2;
+                if ((p << 3) + 4 < height) {
+                    column |= (uint64_t)nibbles[bits >> 4] << shift;
+                    shift += scale << 2;
+                }
+            }
+            for (uint8_t p = page_min; p <= page_max; p++)
+                strip[p] = (uint8_t)(column >> ((p - page_first) * 8));
+        } else {
+            /* Rows are queued LSB first and taken out a page at a time */
+            uint32_t queue = 0;
+            uint8_t queued = offset;
+            int32_t page = page_first;
+            for (uint8_t p = 0; (p < pages) && (page <= page_max); p++) {
+                uint8_t bits;
+                if (columns)
+                    bits = columns[(p * width) + w];
+                else
+                    bits = h_get_glyph_column(bitmap, width, height, w, p);
+
+                uint16_t rows = height - ((uint16_t)p << 3);
+                for (uint8_t row = 0; (row < rows) && (row < 8);) {
+                    uint16_t repeat;
+                    if (nibbles) {
+                        queue |= (uint32_t)nibbles[bits & 0x0F] << queued;
+                        queued += scale << 2;
+                        bits >>= 4;
+                        row += 4;
+                        repeat = 0;
+                    } else {
+                        repeat = scale;
+                    }
+
+                    /* Larger scales repeat the row 16 rows at a time */
+                    do {
+                        if (repeat) {
+                            uint8_t count =
+                                (repeat > 16) ? 16 : (uint8_t)repeat;
+                            if (bits & 1)
+                                queue |= (((uint32_t)1 << count) - 1)
+                                         << queued;
+                            queued += count;
+                            repeat -= count;
+                        }
+                        while (queued >= 8) {
+                            if ((page >= page_min) && (page <= page_max))
+                                strip[page] = (uint8_t)queue;
+                            page++;
+                            queue >>= 8;
+                            queued -= 8;
+                        }
+                    } while (repeat);
+
+                    if (!nibbles) {
+                        bits >>= 1;
+                        row++;
+                    }
+                }
+            }
+            if (queued && (page >= page_min) && (page <= page_max))
+                strip[page] = (uint8_t)queue;
+        }
+
+        for (uint8_t p = page_min; p <= page_max; p++) {
+            uint8_t bits = strip[p] & masks[p];
+            if (bits == 0)
+                continue;
+
+            h_write_mask(display,
+                         &display->data_buffer[SSD1306_PAGE_OFFSETS[p] + x_min],
+                         (uint16_t)(x_max - x_min + 1), bits);
+            if ((uint8_t)x_min < dirty_min[p])
+                dirty_min[p] = (uint8_t)x_min;
+            dirty_max[p] = (uint8_t)x_max;
+        }
+    }
+
+    for (uint8_t p = page_min; p <= page_max; p++) {
+        if (dirty_min[p] <= dirty_max[p])
+            h_set_dirty(display, p, dirty_min[p], dirty_max[p]);
+    }
+}
+
+/**
+ * @brief Gets a byte of a page-major bitmap shifted into a display page.
+ *
+ * @param low Pointer to the bitmap page shifted down into the display page,
+ * or NULL if there's none.
+ * @param high Pointer to the bitmap page above it, shifted up into the display
+ * page, or NULL if there's none.
+ * @param i Column, relative to the pointers.
+ * @param shift Number of rows the bitmap pages are shifted down by [0...7].
+ * @return Rows of the display page.
+ */
+static uint8_t h_get_bitmap_bits(const uint8_t *low, const uint8_t *high,
+                                 uint16_t i, uint8_t shift) {
+    uint8_t bits = 0;
+    if (low)
+        bits = (uint8_t)(low[i] << shift);
+    if (high)
+        bits |= (uint8_t)(high[i] >> (8 - shift));
+    return bits;
+}
+
+/**
+ * @brief Draws a page-major bitmap onto the buffer, limited to the specified
+ * area, same as ssd1306_draw_bitmap_native().
+ *
+ * @note
+ * - The area is in native coordinates, and MUST be within the image and the
+ * buffer.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x0 x-coordinate of the top left pixel of the image.
+ * @param y0 y-coordinate of the top left pixel of the image.
+ * @param bitmap Pointer to the page-major bitmap array.
+ * @param width Width of the image in pixels.
+ * @param height Height of the image in pixels.
+ * @param mode Mode to draw the image with (see ssd1306_bitmap_mode).
+ * @param x_min x-coordinate of the leftmost pixels of the area.
+ * @param y_min y-coordinate of the topmost pixels of the area.
+ * @param x_max x-coordinate of the rightmost pixels of the area.
+ * @param y_max y-coordinate of the bottommost pixels of the area.
+ */
+static void h_draw_native(struct ssd1306_display *display, int32_t x0,
+                          int32_t y0, const uint8_t *bitmap, uint16_t width,
+                          uint16_t height, enum ssd1306_bitmap_mode mode,
+                          int32_t x_min, int32_t y_min, int32_t x_max,
+                          int32_t y_max) {
+    /* Toggling the pixels of the image is the same as the invert mode */
+    if (display->buffer_mode == SSD1306_BUFFER_MODE_XOR)
+        mode = SSD1306_BITMAP_MODE_INVERT;
+
+    int32_t page_first = h_get_page_floor(y0);
+    uint8_t shift = (uint8_t)(y0 - page_first * 8);
+    uint16_t pages = (uint16_t)((height + 7) >> 3);
+
+    uint16_t count = (uint16_t)(x_max - x_min + 1);
+    uint8_t page_min = (uint8_t)(y_min >> 3);
+    uint8_t page_max = (uint8_t)(y_max >> 3);
+    for (uint8_t page = page_min; page <= page_max; page++) {
+        uint8_t mask = 0xFF;
+        if (page == page_min)
+            mask &= (uint8_t)(0xFF << (y_min & 7));
+        if (page == page_max)
+            mask &= (uint8_t)(0xFF >> (7 - (y_max & 7)));
+
+        /* Bitmap pages shifted down into the page, and up from the one above */
+        int32_t source = page - page_first;
+        const uint8_t *low = NULL;
+        const uint8_t *high = NULL;
+        if (source < pages)
+            low = &bitmap[(uint32_t)source * width + (x_min - x0)];
+        if (shift && source > 0)
+            high = &bitmap[(uint32_t)(source - 1) * width + (x_min - x0)];
+
+        uint8_t *byte_ptr =
+            &display->data_buffer[SSD1306_PAGE_OFFSETS[page] + x_min];
+        bool is_inverse = !display->buffer_mode;
+        if (shift == 0 && mask == 0xFF && mode == SSD1306_BITMAP_MODE_OPAQUE &&
+            !is_inverse) {
+            /* Aligned opaque pages are a plain copy */
+            memcpy(byte_ptr, low, count);
+            h_set_dirty(display, page, (uint8_t)x_min, (uint8_t)x_max);
+            continue;
+        }
+
+        if (mode == SSD1306_BITMAP_MODE_OPAQUE) {
+            uint8_t flip = is_inverse ? 0xFF : 0x00;
+            for (uint16_t i = 0; i < count; i++) {
+                uint8_t bits = h_get_bitmap_bits(low, high, i, shift) ^ flip;
+                byte_ptr[i] = (uint8_t)((byte_ptr[i] & ~mask) | (bits & mask));
+            }
+        } else if (mode == SSD1306_BITMAP_MODE_INVERT) {
+            for (uint16_t i = 0; i < count; i++)
+                byte_ptr[i] ^= h_get_bitmap_bits(low, high, i, shift) & mask;
+        } else if (is_inverse) {
+            for (uint16_t i = 0; i < count; i++)
+                byte_ptr[i] &= ~(h_get_bitmap_bits(low, high, i, shift) & mask);
+        } else {
+            for (uint16_t i = 0; i < count; i++)
+                byte_ptr[i] |= h_get_bitmap_bits(low, high, i, shift) & mask;
+        }
+        h_set_dirty(display, page, (uint8_t)x_min, (uint8_t)x_max);
+    }
+}
+
+/**
+ * @brief Draws an 8x8 block of pixels given in the drawing coordinates,
+ * rotated onto the buffer and clipped against the draw border.
+ *
+ * @note
+ * - The block is turned into the native page layout with
+ * h_transpose_8x8()/h_reverse_byte(), then drawn with h_draw_native().
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x0 x-coordinate of the top left pixel of the block.
+ * @param y0 y-coordinate of the top left pixel of the block.
+ * @param block Columns of the block, the top row in the LSB. Rows past the
+ * height are ignored.
+ * @param width Width of the block [1...8].
+ * @param height Height of the block [1...8].
+ * @param mode Mode to draw the block with (see ssd1306_bitmap_mode).
+ */
+static void h_draw_block_rotated(struct ssd1306_display *display, int32_t x0,
+                                 int32_t y0, const uint8_t *block,
+                                 uint8_t width, uint8_t height,
+                                 enum ssd1306_bitmap_mode mode) {
+    uint8_t columns[8] = {0};
+    uint8_t row_mask = (uint8_t)(0xFF >> (8 - height));
+    for (uint8_t i = 0; i < width; i++)
+        columns[i] = block[i] & row_mask;
+
+    /* Native image of the block, and the position of its top left pixel */
+    uint8_t image[8];
+    uint8_t transposed[8];
+    int32_t y_last = h_get_y_max(display);
+    int32_t image_x, image_y;
+    uint8_t image_width = height, image_height = width;
+    if (display->rotation == SSD1306_ROTATION_180) {
+        for (uint8_t i = 0; i < width; i++)
+            image[i] = (uint8_t)(h_reverse_byte(columns[width - 1 - i]) >>
+                                 (8 - height));
+        image_width = width;
+        image_height = height;
+        image_x = SSD1306_X_MAX + 1 - x0 - width;
+        image_y = y_last + 1 - y0 - height;
+    } else if (display->rotation == SSD1306_ROTATION_90) {
+        h_transpose_8x8(columns, transposed);
+        for (uint8_t i = 0; i < height; i++)
+            image[i] = transposed[i + 8 - height];
+        image_x = SSD1306_X_MAX + 1 - y0 - height;
+        image_y = x0;
+    } else {
+        h_transpose_8x8(columns, transposed);
+        for (uint8_t i = 0; i < height; i++)
+            image[i] =
+                (uint8_t)(h_reverse_byte(transposed[7 - i]) >> (8 - width));
+        image_x = y0;
+        image_y = y_last + 1 - x0 - width;
+    }
+
+    /* Native area of the border, clipped to the image */
+    int32_t x_min = display->border_x_min, y_min = display->border_y_min;
+    int32_t x_max = display->border_x_max, y_max = display->border_y_max;
+    h_map_rect(display, &x_min, &y_min, &x_max, &y_max);
+    if (x_min < image_x)
+        x_min = image_x;
+    if (x_max > image_x + image_width - 1)
+        x_max = image_x + image_width - 1;
+    if (y_min < image_y)
+        y_min = image_y;
+    if (y_max > image_y + image_height - 1)
+        y_max = image_y + image_height - 1;
+    if ((x_min > x_max) || (y_min > y_max))
+        return;
+
+    h_draw_native(display, image_x, image_y, image, image_width, image_height,
+                  mode, x_min, y_min, x_max, y_max);
+}
+
+/**
+ * @brief Gets 8 columns of a native page of a page-major bitmap drawn on a
+ * rotated display.
+ *
+ * @note
+ * - On the portrait rotations, the rows of the image are the columns of the
+ * display, so the block is a single transpose of 8 bitmap bytes. 'x' MUST be
+ * where those rows are page aligned (see h_draw_native_rotated()), and the
+ * block MUST overlap the image, then every byte is a whole bitmap byte.
+ *
+ * - When rotated 180 degrees, every column is shifted out of two bitmap pages
+ * and reversed.
+ *
+ * - Pixels outside the image are undefined, bitmap columns outside of it are
+ * never read.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x0 x-coordinate of the top left pixel of the image.
+ * @param y0 y-coordinate of the top left pixel of the image.
+ * @param bitmap Pointer to the page-major bitmap array.
+ * @param width Width of the image in pixels.
+ * @param height Height of the image in pixels.
+ * @param page Page of the display.
+ * @param x Native x-coordinate of the leftmost column of the block.
+ * @param block Pointer to store the 8 columns of the block.
+ */
+static void h_get_native_block_rotated(struct ssd1306_display *display,
+                                       int32_t x0, int32_t y0,
+                                       const uint8_t *bitmap, uint16_t width,
+                                       uint16_t height, uint8_t page,
+                                       int32_t x, uint8_t *block) {
+    int32_t y_last = h_get_y_max(display);
+
+    if (display->rotation == SSD1306_ROTATION_180) {
+        /* Rows of the image in the page, the bottom one first */
+        uint16_t pages = (uint16_t)((height + 7) >> 3);
+        int32_t row = y_last - ((int32_t)page << 3) - 7 - y0;
+        int32_t source = h_get_page_floor(row);
+        uint8_t shift = (uint8_t)(row - source * 8);
+        const uint8_t *low = NULL;
+        const uint8_t *high = NULL;
+        if ((source >= 0) && (source < pages))
+            low = &bitmap[(uint32_t)source * width];
+        if (shift && (source + 1 >= 0) && (source + 1 < pages))
+            high = &bitmap[(uint32_t)(source + 1) * width];
+
+        int32_t column = SSD1306_X_MAX - x - x0;
+        for (uint8_t i = 0; i < 8; i++, column--) {
+            uint8_t bits = 0;
+            if ((column >= 0) && (column < width)) {
+                if (low)
+                    bits = (uint8_t)(low[column] >> shift);
+                if (high)
+                    bits |= (uint8_t)(high[column] << (8 - shift));
+            }
+            block[i] = h_reverse_byte(bits);
+        }
+        return;
+    }
+
+    /* Leftmost of the 8 image columns in the rows of the page (the top row
+     * for 90 degrees, the bottom one for 270), and the page of the image rows
+     * in the columns of the block */
+    bool is_backwards = (display->rotation == SSD1306_ROTATION_270);
+    int32_t column, row;
+    if (is_backwards) {
+        column = y_last - ((int32_t)page << 3) - 7 - x0;
+        row = x - y0;
+    } else {
+        column = ((int32_t)page << 3) - x0;
+        row = SSD1306_X_MAX - 7 - x - y0;
+    }
+    const uint8_t *source = &bitmap[((uint32_t)row >> 3) * width];
+
+    /* Whole bitmap columns are transposed in place, otherwise the columns
+     * outside the image are left empty */
+    uint8_t rows[8];
+    const uint8_t *first = rows;
+    if ((column >= 0) && (column + 7 < width)) {
+        first = &source[column];
+    } else {
+        for (uint8_t i = 0; i < 8; i++, column++)
+            rows[i] = ((column >= 0) && (column < width)) ? source[column] : 0;
+    }
+
+    /* Columns that run backwards give the block rotated 180 degrees */
+    if (is_backwards) {
+        uint8_t columns[8];
+        h_transpose_8x8(first, columns);
+        for (uint8_t i = 0; i < 8; i++)
+            block[i] = h_reverse_byte(columns[7 - i]);
+    } else {
+        h_transpose_8x8(first, block);
+    }
+}
+
+/**
+ * @brief Draws a page-major bitmap on a rotated display, limited to the
+ * specified area, same as ssd1306_draw_bitmap_native().
+ *
+ * @note
+ * - The area is in the drawing coordinates, and MUST be within the image and
+ * the border. It's mapped onto the buffer once, then every page it covers is
+ * written 8 columns at a time with h_get_native_block_rotated() and marked
+ * dirty once.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x0 x-coordinate of the top left pixel of the image.
+ * @param y0 y-coordinate of the top left pixel of the image.
+ * @param bitmap Pointer to the page-major bitmap array.
+ * @param width Width of the image in pixels.
+ * @param height Height of the image in pixels.
+ * @param mode Mode to draw the image with (see ssd1306_bitmap_mode).
+ * @param x_min x-coordinate of the leftmost pixels of the area.
+ * @param y_min y-coordinate of the topmost pixels of the area.
+ * @param x_max x-coordinate of the rightmost pixels of the area.
+ * @param y_max y-coordinate of the bottommost pixels of the area.
+ */
+static void h_draw_native_rotated(struct ssd1306_display *display, int32_t x0,
+                                  int32_t y0, const uint8_t *bitmap,
+                                  uint16_t width, uint16_t height,
+                                  enum ssd1306_bitmap_mode mode, int32_t x_min,
+                                  int32_t y_min, int32_t x_max,
+                                  int32_t y_max) {
+    /* Toggling the pixels of the image is the same as the invert mode */
+    if (display->buffer_mode == SSD1306_BUFFER_MODE_XOR)
+        mode = SSD1306_BITMAP_MODE_INVERT;
+    h_map_rect(display, &x_min, &y_min, &x_max, &y_max);
+
+    /* Portrait blocks start where the rows of the image are page aligned */
+    int32_t x_start = x_min;
+    if (display->rotation == SSD1306_ROTATION_90)
+        x_start -= (int32_t)((uint32_t)(x_min + y0 - (SSD1306_X_MAX - 7)) & 7);
+    else if (display->rotation == SSD1306_ROTATION_270)
+        x_start -= (int32_t)((uint32_t)(x_min - y0) & 7);
+
+    bool is_inverse = !display->buffer_mode;
+    uint8_t flip = is_inverse ? 0xFF : 0x00;
+    uint8_t page_min = (uint8_t)(y_min >> 3);
+    uint8_t page_max = (uint8_t)(y_max >> 3);
+    for (uint8_t page = page_min; page <= page_max; page++) {
+        uint8_t mask = 0xFF;
+        if (page == page_min)
+            mask &= (uint8_t)(0xFF << (y_min & 7));
+        if (page == page_max)
+            mask &= (uint8_t)(0xFF >> (7 - (y_max & 7)));
+
+        uint8_t *row = &display->data_buffer[SSD1306_PAGE_OFFSETS[page]];
+        for (int32_t x = x_start; x <= x_max; x += 8) {
+            uint8_t block[8];
+            h_get_native_block_rotated(display, x0, y0, bitmap, width, height,
+                                       page, x, block);
+
+            /* Columns of the block inside the area */
+            uint8_t first = (x < x_min) ? (uint8_t)(x_min - x) : 0;
+            uint8_t last = (x_max - x < 7) ? (uint8_t)(x_max - x) : 7;
+            uint8_t *byte_ptr = &row[x + first];
+            const uint8_t *bits = &block[first];
+            uint8_t count = (uint8_t)(last - first + 1);
+
+            if (count == 8 && mask == 0xFF &&
+                mode == SSD1306_BITMAP_MODE_OPAQUE && !is_inverse) {
+                /* Whole opaque blocks are a plain copy */
+                memcpy(byte_ptr, block, 8);
+            } else if (mode == SSD1306_BITMAP_MODE_OPAQUE) {
+                for (uint8_t i = 0; i < count; i++)
+                    byte_ptr[i] = (uint8_t)((byte_ptr[i] & ~mask) |
+                                            ((bits[i] ^ flip) & mask));
+            } else if (mode == SSD1306_BITMAP_MODE_INVERT) {
+                for (uint8_t i = 0; i < count; i++)
+                    byte_ptr[i] ^= bits[i] & mask;
+            } else if (is_inverse) {
+                for (uint8_t i = 0; i < count; i++)
+                    byte_ptr[i] &= ~(bits[i] & mask);
+            } else {
+                for (uint8_t i = 0; i < count; i++)
+                    byte_ptr[i] |= bits[i] & mask;
+            }
+        }
+        h_set_dirty(display, page, (uint8_t)x_min, (uint8_t)x_max);
+    }
+}
+
+/**
+ * @brief Draws a glyph on a rotated display, clipped against the draw border.
+ *
+ * @note
+ * - Glyphs at their native size are drawn 8x8 blocks at a time with
+ * h_draw_block_rotated(). Scaled glyphs are drawn as rectangles, one for each
+ * vertical run of set pixels in a column.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x0 x-coordinate of the top left pixel of the glyph.
+ * @param y0 y-coordinate of the top left pixel of the glyph.
+ * @param bitmap Pointer to the row-major bitmap array of the glyph.
+ * @param columns Pointer to the page-major columns of the glyph, or NULL to
+ * read them from the bitmap.
+ * @param width Width of the glyph.
+ * @param height Height of the glyph.
+ * @param scale Scale of the glyph.
+ */
+static void h_draw_glyph_rotated(struct ssd1306_display *display, int32_t x0,
+                                 int32_t y0, const uint8_t *bitmap,
+                                 const uint8_t *columns, uint8_t width,
+                                 uint8_t height, uint8_t scale) {
+    uint8_t pages = (uint8_t)((height + 7) >> 3);
+    for (uint8_t page = 0; page < pages; page++) {
+        uint8_t block_height = 8;
+        if (height - (page << 3) < 8)
+            block_height = (uint8_t)(height - (page << 3));
+        int32_t y = y0 + ((int32_t)page << 3) * scale;
+
+        for (uint16_t x = 0; x < width; x += 8) {
+            uint8_t block_width = 8;
+            if (width - x < 8)
+                block_width = (uint8_t)(width - x);
+            int32_t x_block = x0 + (int32_t)x * scale;
+            if (h_is_box_outside_border(
+                    display, x_block, y, x_block + block_width * scale - 1,
+                    y + block_height * scale - 1))
+                continue;
+
+            uint8_t block[8];
+            if (columns)
+                memcpy(block, &columns[page * width + x], block_width);
+            else
+                h_get_glyph_block(bitmap, width, height, x, page, block);
+            if (scale == 1) {
+                h_draw_block_rotated(display, x_block, y, block, block_width,
+                                     block_height,
+                                     SSD1306_BITMAP_MODE_TRANSPARENT);
+                continue;
+            }
+
+            for (uint8_t i = 0; i < block_width; i++) {
+                uint8_t bits =
+                    (uint8_t)(block[i] & (0xFF >> (8 - block_height)));
+                int32_t x_run = x_block + (int32_t)i * scale;
+                uint8_t row = 0;
+                while (bits) {
+                    if (!(bits & 1)) {
+                        bits >>= 1;
+                        row++;
+                        continue;
+                    }
+                    uint8_t run = 0;
+                    while (bits & 1) {
+                        bits >>= 1;
+                        run++;
+                    }
+                    h_fill_rect(display, x_run, y + (int32_t)row * scale,
+                                x_run + scale - 1,
+                                y + (int32_t)(row + run) * scale - 1);
+                    row = (uint8_t)(row + run);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Draws a character with the specified values at the current cursor
+ * location.
+ *
+ * @note
+ * - Only draws characters with the specified bitmap; doesn't handle special
+ * non-printable characters such as '\\n'.
+ *
+ * - Automatically advances the cursor.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param bitmap Pointer to the bitmap array.
+ * @param width Width of the character. Should match the bitmap or random parts
+ * of the memory may be accessed.
+ * @param height Height of the character. Should match the bitmap or random
+ * parts of the memory may be accessed.
+ * @param x_offset x-offset of the character. Represents the number of pixels
+ * (horizontally) the top-left corner of the bitmap is offset from the current
+ * cursor location.
+ * @param y_offset y-offset of the character. Represents the number of pixels
+ * (vertically) the top-left corner of the bitmap is offset from the current
+ * cursor location.
+ * @param x_advance x-advance of the character. Represents the number of pixels
+ * the cursor should advance after printing.
+ * @param is_cacheable 'true' if the bitmap never changes (font glyphs), so
+ * that it can be kept in the glyph cache.
+ */
+static void h_draw_char(struct ssd1306_display *display, const uint8_t *bitmap,
+                        uint8_t width, uint8_t height, int8_t x_offset,
+                        int8_t y_offset, uint8_t x_advance,
+                        bool is_cacheable) {
+    uint8_t converted[SSD1306_GLYPH_CACHE_SLOT_SIZE];
+    int32_t x0 = (int32_t)display->cursor_x + x_offset;
+    int32_t y0 = (int32_t)display->cursor_y + y_offset;
+    uint8_t scale = display->font_scale;
+    display->cursor_x += (x_advance * scale);
+    if (scale == 0 || width == 0 || height == 0)
+        return;
+    if (h_is_box_outside_border(display, x0, y0,
+                                x0 + (int32_t)width * scale - 1,
+                                y0 + (int32_t)height * scale - 1))
+        return;
+
+    /* Glyphs that aren't cached are converted on the stack if they fit */
+    const uint8_t *columns = NULL;
+    if (is_cacheable)
+        columns = h_get_cached_glyph(bitmap, width, height);
+    if (!columns && (uint16_t)width * ((height + 7) >> 3) <=
+                        SSD1306_GLYPH_CACHE_SLOT_SIZE) {
+        h_convert_glyph(bitmap, width, height, converted);
+        columns = converted;
+    }
+
+    if (display->rotation != SSD1306_ROTATION_0)
+        h_draw_glyph_rotated(display, x0, y0, bitmap, columns, width, height,
+                             scale);
+    else if (scale == 1)
+        h_draw_glyph(display, x0, y0, bitmap, columns, width, height);
+    else
+        h_draw_glyph_scaled(display, x0, y0, bitmap, columns, width, height,
+                            scale);
+}
+
+/**
+ * @brief Inverts all the bits of the specified bytes.
+ *
+ * @note
+ * - Works 16 bytes at a time with SSE2/NEON (see SSD1306_SIMD), then 4 bytes
+ * at a time. Words are accessed through memcpy(), so the bytes don't need to
+ * be aligned.
+ *
+ * @param bytes Pointer to the bytes.
+ * @param count Number of bytes.
+ */
+static void h_invert_bytes(uint8_t *bytes, uint16_t count) {
+#if SSD1306_SIMD == true && defined(__SSE2__)
+    const __m128i ones = _mm_set1_epi8(-1);
+    for (; count >= 16; count -= 16, bytes += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)bytes);
+        _mm_storeu_si128((__m128i *)bytes, _mm_xor_si128(block, ones));
+    }
+#elif SSD1306_SIMD == true && defined(__ARM_NEON)
+    for (; count >= 16; count -= 16, bytes += 16)
+        vst1q_u8(bytes, vmvnq_u8(vld1q_u8(bytes)));
+#endif
+
+    for (; count >= 4; count -= 4, bytes += 4) {
+        uint32_t word;
+        memcpy(&word, bytes, 4);
+        word = ~word;
+        memcpy(bytes, &word, 4);
+    }
+    for (; count; count--, bytes++)
+        *bytes = (uint8_t)~*bytes;
+}
+
+/**
+ * @brief Returns the rows of a page that are within the specified rows.
+ *
+ * @param page Page to get the rows of.
+ * @param y_min y-coordinate of the topmost row.
+ * @param y_max y-coordinate of the bottommost row.
+ * @return Bit mask of the rows, top row in the LSB (0 if none).
+ */
+static uint8_t h_get_page_mask(uint8_t page, int16_t y_min, int16_t y_max) {
+    int16_t top = (int16_t)page << 3;
+    if (y_min < top)
+        y_min = top;
+    if (y_max > top + 7)
+        y_max = top + 7;
+    if (y_min > y_max)
+        return 0x00;
+    return (uint8_t)((0xFF << (y_min - top)) & (0xFF >> (top + 7 - y_max)));
+}
+
+/**
+ * @brief Moves bytes, only changing the bits of the specified mask.
+ *
+ * @param dst Pointer to the destination bytes.
+ * @param src Pointer to the source bytes, can overlap the destination.
+ * @param count Number of bytes.
+ * @param mask Bits to move.
+ */
+static void h_move_masked(uint8_t *dst, const uint8_t *src, uint8_t count,
+                          uint8_t mask) {
+    if (mask == 0xFF) {
+        memmove(dst, src, count);
+        return;
+    }
+    if (dst < src) {
+        for (uint8_t i = 0; i < count; i++)
+            dst[i] = (uint8_t)((dst[i] & ~mask) | (src[i] & mask));
+    } else {
+        for (uint8_t i = count; i > 0; i--)
+            dst[i - 1] = (uint8_t)((dst[i - 1] & ~mask) | (src[i - 1] & mask));
+    }
+}
+
+/**
+ * @brief Reverses the order of bytes, only moving the bits of the specified
+ * mask.
+ *
+ * @param bytes Pointer to the bytes.
+ * @param count Number of bytes.
+ * @param mask Bits to move.
+ */
+static void h_reverse_masked(uint8_t *bytes, uint8_t count, uint8_t mask) {
+    if (count < 2)
+        return;
+
+    uint8_t *last = bytes + count - 1;
+    while (bytes < last) {
+        uint8_t bits = (uint8_t)((*bytes ^ *last) & mask);
+        *bytes++ ^= bits;
+        *last-- ^= bits;
+    }
+}
+
+/**
+ * @brief Sets bytes to a value, only changing the bits of the specified mask.
+ *
+ * @param dst Pointer to the destination bytes.
+ * @param value Value to set.
+ * @param count Number of bytes.
+ * @param mask Bits to set.
+ */
+static void h_fill_masked(uint8_t *dst, uint8_t value, uint8_t count,
+                          uint8_t mask) {
+    if (mask == 0xFF) {
+        memset(dst, value, count);
+        return;
+    }
+    for (uint8_t i = 0; i < count; i++)
+        dst[i] = (uint8_t)((dst[i] & ~mask) | (value & mask));
+}
+
+/**
+ * @brief Combines two rows of page bytes shifted down into one, only changing
+ * the bits of the specified mask.
+ *
+ * @note
+ * - Every destination byte is (a << shift) | (b >> (8 - shift)), 'a' being the
+ * page the rows are shifted down from and 'b' the page above it.
+ *
+ * - Works 4 bytes at a time. Bits that leak into the neighboring bytes of a
+ * word are masked off, so the compiler can use plain word shifts.
+ *
+ * @param dst Pointer to the destination bytes.
+ * @param src_a Pointer to the bytes of page 'a', must be 'dst' itself or not
+ * overlap it.
+ * @param src_b Pointer to the bytes of page 'b', must be 'dst' itself or not
+ * overlap it.
+ * @param shift Number of rows to shift 'a' down by [0...7].
+ * @param count Number of bytes.
+ * @param mask Bits to change.
+ */
+static void h_combine_masked(uint8_t *dst, const uint8_t *src_a,
+                             const uint8_t *src_b, uint8_t shift,
+                             uint8_t count, uint8_t mask) {
+    uint8_t mask_a = (uint8_t)(0xFF << shift) & mask;
+    uint8_t mask_b = (uint8_t)~(0xFF << shift) & mask;
+    uint32_t words_a = 0x01010101u * mask_a;
+    uint32_t words_b = 0x01010101u * mask_b;
+    uint32_t words_keep = ~(0x01010101u * mask);
+
+    uint8_t words = count >> 2;
+    for (uint8_t i = 0; i < words; i++) {
+        uint32_t a, b, word;
+        memcpy(&a, src_a + 4 * i, 4);
+        memcpy(&b, src_b + 4 * i, 4);
+        memcpy(&word, dst + 4 * i, 4);
+        word = (word & words_keep) | ((a << shift) & words_a) |
+               ((b >> (8 - shift)) & words_b);
+        memcpy(dst + 4 * i, &word, 4);
+    }
+    for (uint8_t i = words << 2; i < count; i++) {
+        uint8_t bits =
+            (uint8_t)((src_a[i] << shift) | (src_b[i] >> (8 - shift)));
+        dst[i] = (uint8_t)((dst[i] & ~mask) | (bits & mask));
+    }
+}
+
+/**
+ * @brief Shifts the pixels of a rectangle horizontally.
+ *
+ * @note
+ * - Works a page at a time, in place. Whole pages are moved with memmove(),
+ * partial pages with masked moves.
+ *
+ * - Rotations of up to 8 bytes save the bytes that wrap around. Larger ones
+ * are done with three reversals of the row, so no copy of the row is needed.
+ *
+ * - Pixels that enter the rectangle come from the opposite side if rotated,
+ * otherwise they're determined by the buffer mode.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x_min x-coordinate of the leftmost column.
+ * @param y_min y-coordinate of the topmost row.
+ * @param x_max x-coordinate of the rightmost column.
+ * @param y_max y-coordinate of the bottommost row.
+ * @param count Number of pixels to shift by, positive to shift right.
+ * @param is_rotated 'true' to rotate; 'false' to just shift.
+ */
+static void h_shift_h(struct ssd1306_display *display, uint8_t x_min,
+                      uint8_t y_min, uint8_t x_max, uint8_t y_max,
+                      int16_t count, bool is_rotated) {
+    uint8_t saved[8];
+
+    uint8_t width = (uint8_t)(x_max - x_min + 1);
+    bool is_right = (count > 0);
+    uint16_t n = (uint16_t)(is_right ? count : -count);
+    if (is_rotated)
+        n %= width;
+    else if (n > width)
+        n = width;
+    uint8_t n_keep = (uint8_t)(width - n);
+    uint8_t fill = display->buffer_mode ? 0x00 : 0xFF;
+
+    for (uint8_t page = y_min >> 3; page <= (y_max >> 3); page++) {
+        h_set_dirty(display, page, x_min, x_max);
+        if (n == 0)
+            continue;
+
+        uint8_t mask = h_get_page_mask(page, y_min, y_max);
+        uint8_t *row = &display->data_buffer[SSD1306_PAGE_OFFSETS[page]];
+        row += x_min;
+        if (!is_rotated) {
+            if (is_right) {
+                h_move_masked(row + n, row, n_keep, mask);
+                h_fill_masked(row, fill, (uint8_t)n, mask);
+            } else {
+                h_move_masked(row, row + n, n_keep, mask);
+                h_fill_masked(row + n_keep, fill, (uint8_t)n, mask);
+            }
+        } else if (mask == 0xFF && n <= sizeof(saved)) {
+            if (is_right) {
+                memcpy(saved, row + n_keep, n);
+                memmove(row + n, row, n_keep);
+                memcpy(row, saved, n);
+            } else {
+                memcpy(saved, row, n);
+                memmove(row, row + n, n_keep);
+                memcpy(row + n_keep, saved, n);
+            }
+        } else {
+            /* Reversing the row, then both of its parts, rotates it */
+            uint8_t first = is_right ? (uint8_t)n : n_keep;
+            h_reverse_masked(row, width, mask);
+            h_reverse_masked(row, first, mask);
+            h_reverse_masked(row + first, (uint8_t)(width - first), mask);
+        }
+    }
+}
+
+/**
+ * @brief Finds the source pages of a page after shifting a column vertically.
+ * The page becomes "(a << shift) | (b >> (8 - shift))".
+ *
+ * @note
+ * - Sources outside the specified pages are replaced by the page itself. The
+ * rows they would contribute come from outside the pages, so they're always
+ * masked off by the caller.
+ *
+ * @param page Page to find the sources of.
+ * @param page_min Topmost page of the column.
+ * @param page_max Bottommost page of the column.
+ * @param count Number of rows to shift by, positive to shift down.
+ * @param a Pointer to store the page shifted down into the page.
+ * @param b Pointer to store the page shifted up into the page.
+ * @param shift Pointer to store the number of rows to shift 'a' by [0...7].
+ */
+static void h_get_shift_sources(uint8_t page, uint8_t page_min,
+                                uint8_t page_max, int16_t count, uint8_t *a,
+                                uint8_t *b, uint8_t *shift) {
+    /* Whole pages rounded down, the remainder is always positive */
+    int16_t pages = (int16_t)h_get_page_floor(count);
+    *shift = (uint8_t)(count - pages * 8);
+
+    int16_t source = (int16_t)page - pages;
+    *a = (source >= page_min && source <= page_max) ? (uint8_t)source : page;
+    source--;
+    *b = (source >= page_min && source <= page_max) ? (uint8_t)source : page;
+}
+
+/**
+ * @brief Shifts the pixels of a rectangle vertically.
+ *
+ * @note
+ * - Every page is a combination of two source pages (whole-page steps) with a
+ * single shift for the remainder, so any number of rows takes a single pass.
+ *
+ * - Works in place when not rotated, starting from the page farthest in the
+ * direction of the shift. When rotated, works on a copy of a chunk of
+ * SSD1306_SHIFT_CHUNK columns at a time, so every page is read before it's
+ * overwritten and each page is still processed as a row.
+ *
+ * - Pixels that enter the rectangle come from the opposite side if rotated,
+ * otherwise they're determined by the buffer mode.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x_min x-coordinate of the leftmost column.
+ * @param y_min y-coordinate of the topmost row.
+ * @param x_max x-coordinate of the rightmost column.
+ * @param y_max y-coordinate of the bottommost row.
+ * @param count Number of pixels to shift by, positive to shift down.
+ * @param is_rotated 'true' to rotate; 'false' to just shift.
+ */
+static void h_shift_v(struct ssd1306_display *display, uint8_t x_min,
+                      uint8_t y_min, uint8_t x_max, uint8_t y_max,
+                      int16_t count, bool is_rotated) {
+    uint8_t page_min = y_min >> 3;
+    uint8_t page_max = y_max >> 3;
+    for (uint8_t page = page_min; page <= page_max; page++)
+        h_set_dirty(display, page, x_min, x_max);
+
+    uint8_t height = (uint8_t)(y_max - y_min + 1);
+    bool is_down = (count > 0);
+    int16_t n = is_down ? count : -count;
+    if (is_rotated)
+        n %= height;
+    else if (n > height)
+        n = height;
+    if (n == 0)
+        return;
+
+    /* Rows that enter the rectangle, and how far they come from if rotated */
+    uint8_t masks[8];
+    uint8_t enter_masks[8];
+    for (uint8_t page = page_min; page <= page_max; page++) {
+        masks[page] = h_get_page_mask(page, y_min, y_max);
+        if (is_down)
+            enter_masks[page] = h_get_page_mask(page, y_min, y_min + n - 1);
+        else
+            enter_masks[page] = h_get_page_mask(page, y_max - n + 1, y_max);
+    }
+    int16_t shift = is_down ? n : -n;
+    int16_t shift_wrap = is_down ? (n - height) : (height - n);
+    uint8_t fill = display->buffer_mode ? 0x00 : 0xFF;
+    uint8_t *buffer = display->data_buffer;
+
+    uint8_t a[8], b[8], bits_shift[8];
+    uint8_t a_wrap[8], b_wrap[8], bits_shift_wrap[8];
+    for (uint8_t page = page_min; page <= page_max; page++) {
+        h_get_shift_sources(page, page_min, page_max, shift, &a[page],
+                            &b[page], &bits_shift[page]);
+        h_get_shift_sources(page, page_min, page_max, shift_wrap,
+                            &a_wrap[page], &b_wrap[page],
+                            &bits_shift_wrap[page]);
+    }
+
+    /* Without rotation, every page only comes from the pages it's shifted
+     * away from, so it's done in place starting from the far side */
+    if (!is_rotated) {
+        uint8_t width = (uint8_t)(x_max - x_min + 1);
+        for (uint8_t i = 0; i <= page_max - page_min; i++) {
+            uint8_t page = is_down ? page_max - i : page_min + i;
+            uint8_t *row = &buffer[SSD1306_PAGE_OFFSETS[page] + x_min];
+            h_combine_masked(row,
+                             &buffer[SSD1306_PAGE_OFFSETS[a[page]] + x_min],
+                             &buffer[SSD1306_PAGE_OFFSETS[b[page]] + x_min],
+                             bits_shift[page], width,
+                             masks[page] & (uint8_t)~enter_masks[page]);
+            if (enter_masks[page])
+                h_fill_masked(row, fill, width, enter_masks[page]);
+        }
+        return;
+    }
+
+    /* Chunks are copied SSD1306_SHIFT_CHUNK columns at a time, moved back
+     * from the right edge so the copies have a constant size */
+    uint8_t chunk[8][SSD1306_SHIFT_CHUNK];
+    for (uint16_t x = x_min; x <= x_max; x += SSD1306_SHIFT_CHUNK) {
+        uint8_t width = (x_max - x >= SSD1306_SHIFT_CHUNK - 1)
+                            ? SSD1306_SHIFT_CHUNK
+                            : (uint8_t)(x_max - x + 1);
+        uint16_t x_copy = (x > SSD1306_X_MAX - (SSD1306_SHIFT_CHUNK - 1))
+                              ? SSD1306_X_MAX - (SSD1306_SHIFT_CHUNK - 1)
+                              : x;
+        uint8_t offset = (uint8_t)(x - x_copy);
+        for (uint8_t page = page_min; page <= page_max; page++)
+            memcpy(chunk[page], &buffer[SSD1306_PAGE_OFFSETS[page] + x_copy],
+                   SSD1306_SHIFT_CHUNK);
+
+        for (uint8_t page = page_min; page <= page_max; page++) {
+            uint8_t *row = &buffer[SSD1306_PAGE_OFFSETS[page] + x];
+            uint8_t enter = enter_masks[page];
+            h_combine_masked(row, chunk[a[page]] + offset,
+                             chunk[b[page]] + offset, bits_shift[page], width,
+                             masks[page] & (uint8_t)~enter);
+            if (enter)
+                h_combine_masked(row, chunk[a_wrap[page]] + offset,
+                                 chunk[b_wrap[page]] + offset,
+                                 bits_shift_wrap[page], width, enter);
+        }
+    }
+}
+
+/**
+ * @brief Gets the area the buffer transforms (invert/mirror/shift) work on.
+ *
+ * @note
+ * - The entire buffer in full transform mode, the draw border in border mode.
+ * The area is in native coordinates, the border is mapped onto the buffer if
+ * the display is rotated.
  *
  * @param display Pointer to the ssd1306_display structure.
- * @param length The number of bytes to send. Maximum 8 commands (not checked)!
+ * @param x_min Pointer to store the x-coordinate of the leftmost column.
+ * @param y_min Pointer to store the y-coordinate of the topmost row.
+ * @param x_max Pointer to store the x-coordinate of the rightmost column.
+ * @param y_max Pointer to store the y-coordinate of the bottommost row.
+ * @return 'true' if the area has any pixels; 'false' otherwise.
  */
-static void h_send_cmd_buffer(struct ssd1306_display *display, uint8_t length) {
-    display->cmd_memory[0] = display->i2c_address;
-    display->i2c_write(display->cmd_memory, length + 2);
+static bool h_get_transform_area(struct ssd1306_display *display,
+                                 uint8_t *x_min, uint8_t *y_min,
+                                 uint8_t *x_max, uint8_t *y_max) {
+    if (display->transform_mode == SSD1306_TRANSFORM_MODE_BORDER) {
+        int32_t x0 = display->border_x_min, y0 = display->border_y_min;
+        int32_t x1 = display->border_x_max, y1 = display->border_y_max;
+        if (x0 > x1 || y0 > y1)
+            return false;
+        h_map_rect(display, &x0, &y0, &x1, &y1);
+        *x_min = (uint8_t)x0;
+        *y_min = (uint8_t)y0;
+        *x_max = (uint8_t)x1;
+        *y_max = (uint8_t)y1;
+    } else {
+        *x_min = 0;
+        *y_min = 0;
+        *x_max = SSD1306_X_MAX;
+        *y_max = h_get_y_max(display);
+    }
+    return (*x_min <= *x_max) && (*y_min <= *y_max);
 }
 
 /**
- * @brief Sends the data (draw) buffer to the display.
+ * @brief Shifts the transform area (see h_get_transform_area()), following
+ * the rotation of the display.
  *
  * @param display Pointer to the ssd1306_display structure.
+ * @param count Number of pixels to shift by, in the drawing coordinates.
+ * Positive to shift right/down, negative to shift left/up.
+ * @param is_vertical 'true' to shift up/down; 'false' to shift left/right.
+ * @param is_rotated Same as h_shift_h()/h_shift_v().
  */
-static void h_send_data_buffer(struct ssd1306_display *display) {
-    uint16_t buffer_size;
-    if (display->display_type)
-        buffer_size = SSD1306_ARRAY_SIZE_64;
-    else
-        buffer_size = SSD1306_ARRAY_SIZE_32;
+static void h_shift(struct ssd1306_display *display, int16_t count,
+                    bool is_vertical, bool is_rotated) {
+    uint8_t x_min, y_min, x_max, y_max;
+    if (!h_get_transform_area(display, &x_min, &y_min, &x_max, &y_max))
+        return;
+
+    /* Portrait axes are swapped, with one of them reversed */
+    if (display->rotation == SSD1306_ROTATION_180 ||
+        (display->rotation == SSD1306_ROTATION_90 && is_vertical) ||
+        (display->rotation == SSD1306_ROTATION_270 && !is_vertical))
+        count = (int16_t)-count;
+    if (h_is_portrait(display))
+        is_vertical = !is_vertical;
 
-    *(display->data_buffer - 2) = display->i2c_address;
-    display->i2c_write(display->data_buffer - 2, buffer_size);
+    if (is_vertical)
+        h_shift_v(display, x_min, y_min, x_max, y_max, count, is_rotated);
+    else
+        h_shift_h(display, x_min, y_min, x_max, y_max, count, is_rotated);
 }
 
 /**
- * @brief Checks it the specified point is within the drawing border for the
- * specified display.
- *
- * @note
- * Below are guaranteed:
- *
- * - (x > 0) and (y > 0)
- *
- * - (x < SSD1306_X_MAX)
- *
- * - (y < SSD1306_Y_MAX_32) for 128x32 displays
- *
- * - (y < SSD1306_Y_MAX_64) for 128x64 displays
+ * @brief Inverts the pixels of a rectangle.
  *
  * @param display Pointer to the ssd1306_display structure.
- * @param x x-coordinate to check.
- * @param y y-coordinate to check.
- * @return 'true' if within range; 'false' if out of bounds.
+ * @param x_min x-coordinate of the leftmost column.
+ * @param y_min y-coordinate of the topmost row.
+ * @param x_max x-coordinate of the rightmost column.
+ * @param y_max y-coordinate of the bottommost row.
  */
-static bool h_are_coords_in_border(struct ssd1306_display *display, int16_t x,
-                                   int16_t y) {
-    if ((x < display->border_x_min) || (x > display->border_x_max) ||
-        (y < display->border_y_min) || (y > display->border_y_max))
-        return false;
+static void h_invert_area(struct ssd1306_display *display, uint8_t x_min,
+                          uint8_t y_min, uint8_t x_max, uint8_t y_max) {
+    uint8_t width = (uint8_t)(x_max - x_min + 1);
+    for (uint8_t page = y_min >> 3; page <= y_max >> 3; page++) {
+        h_set_dirty(display, page, x_min, x_max);
+
+        uint8_t mask = h_get_page_mask(page, y_min, y_max);
+        uint8_t *row = &display->data_buffer[SSD1306_PAGE_OFFSETS[page]];
+        if (mask == 0xFF) {
+            h_invert_bytes(row + x_min, width);
+            continue;
+        }
+        for (uint16_t x = x_min; x <= x_max; x++)
+            row[x] ^= mask;
+    }
+}
 
-    return true;
+/**
+ * @brief Horizontally mirrors the pixels of a rectangle.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x_min x-coordinate of the leftmost column.
+ * @param y_min y-coordinate of the topmost row.
+ * @param x_max x-coordinate of the rightmost column.
+ * @param y_max y-coordinate of the bottommost row.
+ */
+static void h_mirror_h_area(struct ssd1306_display *display, uint8_t x_min,
+                            uint8_t y_min, uint8_t x_max, uint8_t y_max) {
+    for (uint8_t page = y_min >> 3; page <= y_max >> 3; page++) {
+        h_set_dirty(display, page, x_min, x_max);
+
+        uint8_t mask = h_get_page_mask(page, y_min, y_max);
+        uint8_t *row = &display->data_buffer[SSD1306_PAGE_OFFSETS[page]];
+        uint8_t *first_ptr = row + x_min;
+        uint8_t *last_ptr = row + x_max;
+        for (; first_ptr < last_ptr; first_ptr++, last_ptr--) {
+            uint8_t first = *first_ptr;
+            uint8_t last = *last_ptr;
+            *first_ptr = (uint8_t)((first & ~mask) | (last & mask));
+            *last_ptr = (uint8_t)((last & ~mask) | (first & mask));
+        }
+    }
 }
 
 /**
- * @brief Draws a character with the specified values at the current cursor
- * location.
+ * @brief Vertically mirrors the pixels of a rectangle.
  *
  * @note
- * - Only draws characters with the specified bitmap; doesn't handle special
- * non-printable characters such as '\\n'.
- *
- * - Automatically advances the cursor.
+ * - Works a column at a time. Reversing the order of the pages and the bits
+ * within them mirrors the pages around their own center, which is at most 7
+ * rows off from the center of the rectangle. A single shift fixes that.
  *
  * @param display Pointer to the ssd1306_display structure.
- * @param bitmap Pointer to the bitmap array.
- * @param width Width of the character. Should match the bitmap or random parts
- * of the memory may be accessed.
- * @param height Height of the character. Should match the bitmap or random
- * parts of the memory may be accessed.
- * @param x_offset x-offset of the character. Represents the number of pixels
- * (horizontally) the top-left corner of the bitmap is offset from the current
- * cursor location.
- * @param y_offset y-offset of the character. Represents the number of pixels
- * (vertically) the top-left corner of the bitmap is offset from the current
- * cursor location.
- * @param x_advance x-advance of the character. Represents the number of pixels
- * the cursor should advance after printing.
+ * @param x_min x-coordinate of the leftmost column.
+ * @param y_min y-coordinate of the topmost row.
+ * @param x_max x-coordinate of the rightmost column.
+ * @param y_max y-coordinate of the bottommost row.
  */
-static void h_draw_char(struct ssd1306_display *display, const uint8_t *bitmap,
-                        uint8_t width, uint8_t height, int8_t x_offset,
-                        int8_t y_offset, uint8_t x_advance) {
-    int16_t x0 = display->cursor_x + x_offset;
-    int16_t y0 = display->cursor_y + y_offset;
-    uint8_t scale = display->font_scale;
-    uint8_t count = 0;
-    uint8_t pixels;
-    for (uint8_t h = 0; h < height; h++) {
-        for (uint8_t w = 0; w < width; w++) {
-            if (count == 0) {
-                count = 8;
-                pixels = *bitmap++;
-            }
-            count--;
+static void h_mirror_v_area(struct ssd1306_display *display, uint8_t x_min,
+                            uint8_t y_min, uint8_t x_max, uint8_t y_max) {
+    uint8_t page_min = y_min >> 3;
+    uint8_t page_max = y_max >> 3;
+    int16_t count = (int16_t)(y_min + y_max) -
+                    (int16_t)(((page_min + page_max) << 3) + 7);
+
+    uint8_t masks[8], a[8], b[8], bits_shift[8];
+    for (uint8_t page = page_min; page <= page_max; page++) {
+        h_set_dirty(display, page, x_min, x_max);
+        masks[page] = h_get_page_mask(page, y_min, y_max);
+        h_get_shift_sources(page, page_min, page_max, count, &a[page],
+                            &b[page], &bits_shift[page]);
+    }
 
-            if (pixels & 0x80) {
-                ssd1306_draw_rect_fill(display, x0 + (w * scale),
-                                       y0 + (h * scale), scale, scale);
-            }
-            pixels <<= 1;
+    uint8_t *buffer = display->data_buffer;
+    uint8_t reversed[8];
+    for (uint8_t x = x_min; x <= x_max; x++) {
+        for (uint8_t page = page_min; page <= page_max; page++) {
+            uint8_t source = (uint8_t)(page_min + page_max - page);
+            reversed[page] =
+                h_reverse_byte(buffer[SSD1306_PAGE_OFFSETS[source] + x]);
+        }
+
+        for (uint8_t page = page_min; page <= page_max; page++) {
+            uint8_t s = bits_shift[page];
+            uint8_t bits = (uint8_t)((reversed[a[page]] << s) |
+                                     (reversed[b[page]] >> (8 - s)));
+            uint8_t mask = masks[page];
+            uint8_t *byte_ptr = &buffer[SSD1306_PAGE_OFFSETS[page] + x];
+            *byte_ptr = (uint8_t)((*byte_ptr & ~mask) | (bits & mask));
         }
     }
-    display->cursor_x += (x_advance * scale);
 }
 
+/*----------------------------------------------------------------------------*/
+/*----------------------------- Transport Backends ---------------------------*/
+/*----------------------------------------------------------------------------*/
+
 /**
- * @brief Returns the reversed version of the byte.
+ * @brief Sends commands over I2C. Prepends the I2C address and the command
+ * control byte in the two bytes preceding the commands.
  *
- * @param byte Byte to be reversed.
- * @return Reversed byte.
+ * @param display Pointer to the ssd1306_display structure.
+ * @param cmd Pointer to the commands. The two bytes before are overwritten.
+ * @param length The number of command bytes.
  */
-static uint8_t h_reverse_byte(uint8_t byte) {
-    uint8_t result = 0;
-    for (uint8_t i = 0; i < 8; i++) {
-        result = (uint8_t)(result << 1) | (byte & 1);
-        byte >>= 1;
-    }
-    return result;
+static void h_i2c_write_cmd(struct ssd1306_display *display, uint8_t *cmd,
+                            uint16_t length) {
+    *(cmd - 2) = display->i2c_address;
+    *(cmd - 1) = SSD1306_CONTROL_CMD;
+    display->i2c_write(cmd - 2, length + 2);
+}
+
+/**
+ * @brief Sends data over I2C. Prepends the I2C address and the data control
+ * byte in the two bytes preceding the data.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param data Pointer to the data. The two bytes before are overwritten.
+ * @param length The number of data bytes.
+ */
+static void h_i2c_write_data(struct ssd1306_display *display, uint8_t *data,
+                             uint16_t length) {
+    *(data - 2) = display->i2c_address;
+    *(data - 1) = SSD1306_CONTROL_DATA;
+    display->i2c_write(data - 2, length + 2);
+}
+
+/**
+ * @brief Sends commands over 4-wire SPI (D/C low).
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param cmd Pointer to the commands.
+ * @param length The number of command bytes.
+ */
+static void h_spi_write_cmd(struct ssd1306_display *display, uint8_t *cmd,
+                            uint16_t length) {
+    display->spi_dc_write(false);
+    display->spi_write(cmd, length);
+}
+
+/**
+ * @brief Sends data over 4-wire SPI (D/C high).
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param data Pointer to the data.
+ * @param length The number of data bytes.
+ */
+static void h_spi_write_data(struct ssd1306_display *display, uint8_t *data,
+                             uint16_t length) {
+    display->spi_dc_write(true);
+    display->spi_write(data, length);
 }
 
+/*
+ * I2C transport. Each transaction starts with the I2C address and a control
+ * byte.
+ */
+const struct ssd1306_transport ssd1306_transport_i2c = {
+    h_i2c_write_cmd, h_i2c_write_data, 2};
+
+/*
+ * 4-wire SPI transport. Commands and data are told apart by the D/C line.
+ */
+const struct ssd1306_transport ssd1306_transport_spi = {
+    h_spi_write_cmd, h_spi_write_data, 0};
+
 /*----------------------------------------------------------------------------*/
 /*------------------------------ Init Functions ------------------------------*/
 /*----------------------------------------------------------------------------*/
 
+/**
+ * @brief Initializes the buffers of the ssd1306_display structure, and then
+ * the display itself.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param display_type Display type (128x32 or 128x64).
+ * @param array Pointer to the array that will serve as the buffer.
+ */
+static void h_init(struct ssd1306_display *display,
+                   enum ssd1306_display_type display_type, uint8_t *array) {
+    /*
+     * The actual data (draw) buffer starts with a 2 byte offset. The first two
+     * bytes are reserved for the transport header ("I2C address" and "data
+     * mode" for I2C). This way the whole transmission (data_buffer_ptr - 2)
+     * can be sent to the write function.
+     *
+     * The same also applies for the command buffer. The first two bytes are
+     * reserved for the transport header ("I2C address" and "cmd mode" for
+     * I2C). Beware of the max command length (ssd1306_display.cmd_memory[]).
+     *
+     * NEVER modify the address of data_buffer! The cmd_buffer only moves
+     * during command batches (see h_send_cmd_buffer()).
+     */
+    array[0] = display->i2c_address;
+    array[1] = SSD1306_CONTROL_DATA;
+    display->data_buffer = &array[2];
+    display->tx_buffer = display->data_buffer;
+
+    display->cmd_memory[1] = SSD1306_CONTROL_CMD;
+    display->cmd_buffer = &display->cmd_memory[2];
+    display->cmd_batch_length = 0;
+    display->is_cmd_batch = false;
+    display->is_update_pending = false;
+
+#if SSD1306_ASYNC_TRANSFER == true
+    /* The transmit buffer (with its own 2 byte header) follows the data buffer
+     * in the same array. It always holds what the display holds, so it can
+     * double as the shadow buffer. */
+    if (display_type)
+        display->tx_buffer = &array[2 + SSD1306_BUFFER_SIZE_64 + 2];
+    else
+        display->tx_buffer = &array[2 + SSD1306_BUFFER_SIZE_32 + 2];
+    display->is_busy = false;
+    display->is_step_update = false;
+#if SSD1306_SHADOW_BUFFER == true
+    display->shadow_buffer = display->tx_buffer;
+#endif
+#elif SSD1306_SHADOW_BUFFER == true
+    /* The shadow buffer follows the data buffer in the same array */
+    if (display_type)
+        display->shadow_buffer = &array[2 + SSD1306_BUFFER_SIZE_64];
+    else
+        display->shadow_buffer = &array[2 + SSD1306_BUFFER_SIZE_32];
+#endif
+    display->span_length = 0;
+    display->window_count = 0;
+    display->window_index = 0;
+    display->transfer_limit = UINT16_MAX;
+
+    display->display_type = display_type;
+
+    /* Rest of the structure is initialized here */
+    ssd1306_reinit(display);
+}
+
 /**
  * @brief Initializes the ssd1306_display structure as well as the display.
  *
@@ -231,6 +3517,8 @@ static uint8_t h_reverse_byte(uint8_t byte) {
  * - The display will reset to default configurations. These configurations are
  * defined as macros in the ssd1306.h file under the Library Setup section.
  *
+ * - For displays connected via SPI, use ssd1306_init_spi() instead.
+ *
  * @param display Pointer to the ssd1306_display structure.
  * @param i2c_address 7-bit I2C address of the display.
  * @param display_type Display type (128x32 or 128x64). Use the
@@ -240,35 +3528,91 @@ static uint8_t h_reverse_byte(uint8_t byte) {
  * the appropriate size based on the display type.
  * @param i2c_write Pointer to the callback function that writes a stream of
  * data to the I2C bus. For proper setup, refer to
- * https://github.com/Microesque/SSD1306/wiki/Setup-Guide.
+ * https://github.com/Microesque/SSD1306/wiki/Setup-Guide. With
+ * SSD1306_ASYNC_TRANSFER, the callback must only start the transfer, and
+ * ssd1306_transfer_complete() must be called once it's complete.
  */
 void ssd1306_init(struct ssd1306_display *display, uint8_t i2c_address,
                   enum ssd1306_display_type display_type, uint8_t *array,
                   void (*i2c_write)(uint8_t *data, uint16_t length)) {
-    /*
-     * The actual data (draw) buffer starts with a 2 byte offset. The first two
-     * bytes are reserved for "I2C address" and "data mode". This way the whole
-     * I2C transmission (data_buffer_ptr - 2) can be sent to the write function.
-     *
-     * The same also applies for the command buffer. The first two bytes are
-     * reserved for "I2C address" and "cmd mode". This way the whole I2C
-     * transmission (cmd_buffer_ptr - 2) can be sent to the write function.
-     * Beware of the max command length (ssd1306_display.cmd_memory[]).
-     *
-     * NEVER modify the addresses of data_buffer and cmd_buffer!
-     */
-    array[1] = SSD1306_CONTROL_DATA;
-    display->data_buffer = &array[2];
-
-    display->cmd_memory[1] = SSD1306_CONTROL_CMD;
-    display->cmd_buffer = &display->cmd_memory[2];
-
+    display->transport = &ssd1306_transport_i2c;
+    display->transport_context = NULL;
     display->i2c_address = (uint8_t)(i2c_address << 1); /* Write only */
     display->i2c_write = i2c_write;
-    display->display_type = display_type;
+    display->spi_write = NULL;
+    display->spi_dc_write = NULL;
+    h_init(display, display_type, array);
+}
 
-    /* Rest of the structure is initialized here */
-    ssd1306_reinit(display);
+/**
+ * @brief Initializes the ssd1306_display structure as well as the display, for
+ * displays connected via 4-wire SPI.
+ *
+ * @note
+ * - Same as ssd1306_init(), but commands and data are told apart by the D/C
+ * line instead of I2C control bytes. Chip select and reset are left to the
+ * user (the chip select can be handled inside spi_write).
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param display_type Display type (128x32 or 128x64). Use the
+ * ssd1306_display_type enum provided in the header file.
+ * @param array Pointer to the array that will serve as the buffer for the
+ * display. Use the macros provided in the header file to declare an array of
+ * the appropriate size based on the display type.
+ * @param spi_write Pointer to the callback function that writes a stream of
+ * data to the SPI bus. With SSD1306_ASYNC_TRANSFER, the callback must only
+ * start the transfer, and ssd1306_transfer_complete() must be called once it's
+ * complete.
+ * @param spi_dc_write Pointer to the callback function that sets the D/C pin
+ * ('true' -> high for data; 'false' -> low for commands). Only called when no
+ * transfer is ongoing.
+ */
+void ssd1306_init_spi(struct ssd1306_display *display,
+                      enum ssd1306_display_type display_type, uint8_t *array,
+                      void (*spi_write)(uint8_t *data, uint16_t length),
+                      void (*spi_dc_write)(bool is_data)) {
+    display->transport = &ssd1306_transport_spi;
+    display->transport_context = NULL;
+    display->i2c_address = 0;
+    display->i2c_write = NULL;
+    display->spi_write = spi_write;
+    display->spi_dc_write = spi_dc_write;
+    h_init(display, display_type, array);
+}
+
+/**
+ * @brief Initializes the ssd1306_display structure as well as the display,
+ * using a custom transport.
+ *
+ * @note
+ * - Meant for buses other than I2C and SPI, or for mock transports (testing on
+ * a host machine). The transport functions receive the display structure, so
+ * the context can be retrieved with ssd1306_get_transport_context().
+ *
+ * - The two bytes before every command/data pointer passed to the transport
+ * functions may be overwritten (the library restores them afterwards).
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param display_type Display type (128x32 or 128x64). Use the
+ * ssd1306_display_type enum provided in the header file.
+ * @param array Pointer to the array that will serve as the buffer for the
+ * display. Use the macros provided in the header file to declare an array of
+ * the appropriate size based on the display type.
+ * @param transport Pointer to the transport. Must remain valid.
+ * @param context Arbitrary pointer for the transport to use.
+ */
+void ssd1306_init_transport(struct ssd1306_display *display,
+                            enum ssd1306_display_type display_type,
+                            uint8_t *array,
+                            const struct ssd1306_transport *transport,
+                            void *context) {
+    display->transport = transport;
+    display->transport_context = context;
+    display->i2c_address = 0;
+    display->i2c_write = NULL;
+    display->spi_write = NULL;
+    display->spi_dc_write = NULL;
+    h_init(display, display_type, array);
 }
 
 /**
@@ -285,6 +3629,58 @@ void ssd1306_init(struct ssd1306_display *display, uint8_t i2c_address,
  * @param display Pointer to the ssd1306_display structure.
  */
 void ssd1306_reinit(struct ssd1306_display *display) {
+    ssd1306_set_update_mode(display, SSD1306_DEFAULT_UPDATE_MODE);
+
+    /* Pushed onto the display by ssd1306_display_resync() */
+    display->reg_brightness = SSD1306_DEFAULT_BRIGHTNESS;
+    display->is_reg_enabled = SSD1306_DEFAULT_ENABLE;
+    display->is_reg_fully_on = SSD1306_DEFAULT_FULLY_ON;
+    display->is_reg_inverse = SSD1306_DEFAULT_INVERSE;
+    display->is_reg_mirror_h = SSD1306_DEFAULT_MIRROR_H;
+    display->is_reg_mirror_v = SSD1306_DEFAULT_MIRROR_V;
+
+#if SSD1306_DEFAULT_CLEAR_BUFFER == true && SSD1306_DEFAULT_FILL_BUFFER == false
+    ssd1306_draw_clear(display);
+#endif
+#if SSD1306_DEFAULT_FILL_BUFFER == true
+    ssd1306_draw_fill(display);
+#endif
+    display->rotation = SSD1306_ROTATION_0;
+    uint8_t border_y1;
+    if (display->display_type)
+        border_y1 = SSD1306_DEFAULT_DRAW_BORDER_Y1_64;
+    else
+        border_y1 = SSD1306_DEFAULT_DRAW_BORDER_Y1_32;
+    ssd1306_set_draw_border(display, SSD1306_DEFAULT_DRAW_BORDER_X0,
+                            SSD1306_DEFAULT_DRAW_BORDER_Y0,
+                            SSD1306_DEFAULT_DRAW_BORDER_X1, border_y1);
+    ssd1306_set_buffer_mode(display, SSD1306_DEFAULT_BUFFER_MODE);
+    ssd1306_set_transform_mode(display, SSD1306_DEFAULT_TRANSFORM_MODE);
+    ssd1306_set_rotation(display, SSD1306_DEFAULT_ROTATION);
+    ssd1306_set_font(display, SSD1306_DEFAULT_FONT);
+    ssd1306_set_font_scale(display, SSD1306_DEFAULT_FONT_SCALE);
+    ssd1306_set_cursor(display, SSD1306_DEFAULT_CURSOR_X,
+                       SSD1306_DEFAULT_CURSOR_Y);
+
+    ssd1306_display_resync(display);
+}
+
+/**
+ * @brief Re-sends the entire display configuration and the buffer contents,
+ * regardless of what the display is assumed to hold.
+ *
+ * @note
+ * - The display functions (brightness/inverse/mirror/etc.) skip the commands
+ * that wouldn't change anything. Use this function after the display has been
+ * reset or re-powered behind the library's back (e.g. reset pin, brown-out,
+ * bus glitch), so that the display matches the library again.
+ *
+ * - Unlike ssd1306_reinit(), keeps the current configuration and the buffer
+ * contents. An ongoing scroll is stopped.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+void ssd1306_display_resync(struct ssd1306_display *display) {
     /*
      * Some commands are omitted here since their default state is the same as
      * intended, and the library never changes them.
@@ -293,6 +3689,16 @@ void ssd1306_reinit(struct ssd1306_display *display) {
      * re-inits the display.
      */
 
+    /* The display contents, the address pointer and the registers are unknown
+     */
+    display->is_reg_valid = false;
+    display->is_window_full = false;
+    h_set_display_unknown(display);
+    bool is_enabled = display->is_reg_enabled;
+
+    /* Send all the commands at once, and push the frame only once at the end */
+    ssd1306_display_batch_begin(display);
+
     /* Avoid corruption */
     ssd1306_display_scroll_disable(display);
 
@@ -307,6 +3713,7 @@ void ssd1306_reinit(struct ssd1306_display *display) {
     else
         cmd_buffer[1] = 0x1F;
     h_send_cmd_buffer(display, 2);
+    cmd_buffer = display->cmd_buffer;
 
     cmd_buffer[0] = SSD1306_CMD_SET_COM_CONFIGURATION;
     if (display->display_type)
@@ -314,6 +3721,7 @@ void ssd1306_reinit(struct ssd1306_display *display) {
     else
         cmd_buffer[1] = 0x02;
     h_send_cmd_buffer(display, 2);
+    cmd_buffer = display->cmd_buffer;
 
     cmd_buffer[0] = SSD1306_CMD_SET_VERTICAL_SCROLL_AREA;
     cmd_buffer[1] = 0x00;
@@ -322,6 +3730,13 @@ void ssd1306_reinit(struct ssd1306_display *display) {
     else
         cmd_buffer[2] = 0x20;
     h_send_cmd_buffer(display, 3);
+    cmd_buffer = display->cmd_buffer;
+
+    /* Page/column address commands are ignored in page addressing mode */
+    cmd_buffer[0] = SSD1306_CMD_SET_MEMORY_ADDRESSING_MODE;
+    cmd_buffer[1] = 0x00;
+    h_send_cmd_buffer(display, 2);
+    cmd_buffer = display->cmd_buffer;
 
     cmd_buffer[0] = SSD1306_CMD_SET_PAGE_ADDRESS; /* Resets address ptr */
     cmd_buffer[1] = 0x00;
@@ -330,79 +3745,239 @@ void ssd1306_reinit(struct ssd1306_display *display) {
     else
         cmd_buffer[2] = 0x03;
     h_send_cmd_buffer(display, 3);
+    cmd_buffer = display->cmd_buffer;
 
     cmd_buffer[0] = SSD1306_CMD_SET_COLUMN_ADDRESS; /* Resets address ptr */
     cmd_buffer[1] = 0x00;
     cmd_buffer[2] = 0x7F;
     h_send_cmd_buffer(display, 3);
-
-    cmd_buffer[0] = SSD1306_CMD_SET_MEMORY_ADDRESSING_MODE;
-    cmd_buffer[1] = 0x00;
-    h_send_cmd_buffer(display, 2);
+    cmd_buffer = display->cmd_buffer;
+    display->is_window_full = true;
 
     cmd_buffer[0] = SSD1306_CMD_SET_DIV_RATIO_AND_FREQ;
     cmd_buffer[1] = 0xF0;
     h_send_cmd_buffer(display, 2);
+    cmd_buffer = display->cmd_buffer;
 
     cmd_buffer[0] = SSD1306_CMD_SET_CHARGE_PUMP;
     cmd_buffer[1] = 0x14;
     h_send_cmd_buffer(display, 2);
 
-    ssd1306_display_brightness(display, SSD1306_DEFAULT_BRIGHTNESS);
-    ssd1306_display_fully_on(display, SSD1306_DEFAULT_FULLY_ON);
-    ssd1306_display_inverse(display, SSD1306_DEFAULT_INVERSE);
-    ssd1306_display_mirror_h(display, SSD1306_DEFAULT_MIRROR_H);
-    ssd1306_display_mirror_v(display, SSD1306_DEFAULT_MIRROR_V);
+    ssd1306_display_brightness(display, display->reg_brightness);
+    ssd1306_display_fully_on(display, display->is_reg_fully_on);
+    ssd1306_display_inverse(display, display->is_reg_inverse);
+    ssd1306_display_mirror_h(display, display->is_reg_mirror_h);
+    ssd1306_display_mirror_v(display, display->is_reg_mirror_v);
+    ssd1306_display_batch_end(display);
+
+    /* Do the enable at the end */
+    ssd1306_display_enable(display, is_enabled);
+    display->is_reg_valid = true;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------- Display Functions ----------------------------*/
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @brief Updates the display with the current internal buffer contents.
+ *
+ * @note
+ * - For more information, refer to
+ * https://github.com/Microesque/SSD1306/wiki/Getting-Started.
+ *
+ * - In dirty mode, only the columns modified since the last update are sent.
+ * In diff mode, only the bytes that differ from the display contents are sent.
+ * The update mode can be set with the ssd1306_set_update_mode() function.
+ *
+ * - With SSD1306_ASYNC_TRANSFER, waits for the previous update to complete,
+ * copies the modified parts to the transmit buffer, starts the transfer and
+ * returns. Drawing can continue right away.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+void ssd1306_display_update(struct ssd1306_display *display) {
+    h_wait_idle(display);
+    h_flush_cmd_batch(display);
+    display->is_update_pending = false;
+    h_queue_update(display);
+
+    display->transfer_limit = UINT16_MAX;
+#if SSD1306_ASYNC_TRANSFER == true
+    display->is_step_update = false;
+    h_transfer_next(display, UINT16_MAX);
+#else
+    while (h_transfer_next(display, UINT16_MAX)) {
+    }
+#endif
+}
+
+/**
+ * @brief Sends the next part of the update, taking at most the specified
+ * number of bytes on the bus. Call repeatedly until it returns 'true'.
+ *
+ * @note
+ * - Meant for control loops that can't block for a full update, and for
+ * peripherals that can't send long transfers at once. Each call takes a
+ * bounded amount of bus time, and no single transfer exceeds the limit.
+ *
+ * - The first call after a completed update starts a new update, exactly like
+ * ssd1306_display_update() does (same update modes and statistics).
+ *
+ * - Drawing between the calls is allowed. Modified parts that have already
+ * been sent are sent again with the next update.
+ *
+ * - With SSD1306_ASYNC_TRANSFER, the transfers are already non-blocking. The
+ * limit then only bounds the length of each transfer, and the function
+ * returns 'true' once the started update is complete.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param max_bytes Maximum number of bytes to send per call, including the I2C
+ * address and control bytes (none for SPI). Values below 8 are treated as 8.
+ * @return 'true' if the update is complete; 'false' if more calls are needed.
+ */
+bool ssd1306_display_update_step(struct ssd1306_display *display,
+                                 uint16_t max_bytes) {
+    if (max_bytes < 8)
+        max_bytes = 8;
+
+#if SSD1306_ASYNC_TRANSFER == true
+    if (display->is_busy)
+        return false;
+    h_flush_cmd_batch(display);
+
+    /* Report the completion of the update started by this function once */
+    if (display->is_step_update) {
+        display->is_step_update = false;
+        return true;
+    }
+
+    display->is_update_pending = false;
+    h_queue_update(display);
+    if (display->window_count == 0)
+        return true;
+
+    display->is_step_update = true;
+    display->transfer_limit = max_bytes;
+    h_transfer_next(display, max_bytes);
+    return false;
+#else
+    h_flush_cmd_batch(display);
+    if (display->window_index >= display->window_count) {
+        display->is_update_pending = false;
+        h_queue_update(display);
+        if (display->window_count == 0)
+            return true;
+    }
 
-#if SSD1306_DEFAULT_CLEAR_BUFFER == true && SSD1306_DEFAULT_FILL_BUFFER == false
-    ssd1306_draw_clear(display);
-#endif
-#if SSD1306_DEFAULT_FILL_BUFFER == true
-    ssd1306_draw_fill(display);
+    uint16_t length;
+    while ((length = h_transfer_next(display, max_bytes)) != 0) {
+        max_bytes -= length;
+    }
+    return display->window_index >= display->window_count;
 #endif
-    uint8_t border_y1;
-    if (display->display_type)
-        border_y1 = SSD1306_DEFAULT_DRAW_BORDER_Y1_64;
-    else
-        border_y1 = SSD1306_DEFAULT_DRAW_BORDER_Y1_32;
-    ssd1306_set_draw_border(display, SSD1306_DEFAULT_DRAW_BORDER_X0,
-                            SSD1306_DEFAULT_DRAW_BORDER_Y0,
-                            SSD1306_DEFAULT_DRAW_BORDER_X1, border_y1);
-    ssd1306_set_buffer_mode(display, SSD1306_DEFAULT_BUFFER_MODE);
-    ssd1306_set_font(display, SSD1306_DEFAULT_FONT);
-    ssd1306_set_font_scale(display, SSD1306_DEFAULT_FONT_SCALE);
-    ssd1306_set_cursor(display, SSD1306_DEFAULT_CURSOR_X,
-                       SSD1306_DEFAULT_CURSOR_Y);
+}
 
-    /* Do the enable at the end */
-    ssd1306_display_enable(display, SSD1306_DEFAULT_ENABLE);
+/**
+ * @brief Checks if an asynchronous transfer is still ongoing.
+ *
+ * @note
+ * - Only meaningful with SSD1306_ASYNC_TRANSFER. Always returns 'false'
+ * otherwise, as every transfer completes before the functions return.
+ *
+ * - Functions that need the bus wait for the ongoing transfer anyway. Use this
+ * function to do other work instead of waiting.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @return 'true' if a transfer is ongoing; 'false' otherwise.
+ */
+bool ssd1306_display_is_busy(struct ssd1306_display *display) {
+#if SSD1306_ASYNC_TRANSFER == true
+    return display->is_busy;
+#else
+    (void)display;
+    return false;
+#endif
 }
 
-/*----------------------------------------------------------------------------*/
-/*----------------------------- Display Functions ----------------------------*/
-/*----------------------------------------------------------------------------*/
+/**
+ * @brief Notifies the library that the last started transfer is complete.
+ *
+ * @note
+ * - Only used with SSD1306_ASYNC_TRANSFER. Call it from the DMA/I2C interrupt
+ * handler (or wherever the completion of the i2c_write callback is detected).
+ * The next transfer of the frame, if any, is started from within this function.
+ *
+ * - Does nothing if SSD1306_ASYNC_TRANSFER is disabled.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+void ssd1306_transfer_complete(struct ssd1306_display *display) {
+#if SSD1306_ASYNC_TRANSFER == true
+    h_end_data_span(display);
+    if (!h_transfer_next(display, display->transfer_limit))
+        display->is_busy = false;
+#else
+    (void)display;
+#endif
+}
 
 /**
- * @brief Updates the display with the current internal buffer contents.
+ * @brief Starts batching the commands of the subsequent display functions.
  *
  * @note
- * - For more information, refer to
- * https://github.com/Microesque/SSD1306/wiki/Getting-Started.
+ * - Until ssd1306_display_batch_end() is called, the display functions
+ * (brightness/inverse/mirror/etc.) don't send their commands right away.
+ * Instead, the commands are collected and sent together in a single
+ * transaction, saving the per-transaction overhead (start condition, address,
+ * control byte, stop).
+ *
+ * - Display updates that the functions would do on their own (e.g.
+ * ssd1306_display_mirror_h()) are postponed to ssd1306_display_batch_end(),
+ * and done only once.
+ *
+ * - Calling ssd1306_display_update() during a batch sends the batched commands
+ * first, then updates the display. The batch continues afterwards.
+ *
+ * - If the batch grows past SSD1306_CMD_BATCH_LIMIT, it's split into multiple
+ * transactions.
  *
  * @param display Pointer to the ssd1306_display structure.
  */
-void ssd1306_display_update(struct ssd1306_display *display) {
-    h_send_data_buffer(display);
+void ssd1306_display_batch_begin(struct ssd1306_display *display) {
+    display->is_cmd_batch = true;
+}
+
+/**
+ * @brief Sends the commands batched since ssd1306_display_batch_begin(), and
+ * does the postponed display update (if any).
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ */
+void ssd1306_display_batch_end(struct ssd1306_display *display) {
+    h_flush_cmd_batch(display);
+    display->is_cmd_batch = false;
+    if (display->is_update_pending)
+        ssd1306_display_update(display);
 }
 
 /**
  * @brief Sets the brightness level of the display.
  *
+ * @note
+ * - Like the other display functions, nothing is sent if the display already
+ * has the same setting. Use ssd1306_display_resync() if the display has been
+ * reset behind the library's back.
+ *
  * @param display Pointer to the ssd1306_display structure.
  * @param brightness Brightness level [0-255].
  */
 void ssd1306_display_brightness(struct ssd1306_display *display,
                                 uint8_t brightness) {
+    if (display->is_reg_valid && display->reg_brightness == brightness)
+        return;
+    display->reg_brightness = brightness;
+
     display->cmd_buffer[0] = SSD1306_CMD_SET_CONTRAST_CONTROL;
     display->cmd_buffer[1] = brightness;
     h_send_cmd_buffer(display, 2);
@@ -420,6 +3995,10 @@ void ssd1306_display_brightness(struct ssd1306_display *display,
  * @param is_enabled 'true' to enable; 'false' to disable.
  */
 void ssd1306_display_enable(struct ssd1306_display *display, bool is_enabled) {
+    if (display->is_reg_valid && display->is_reg_enabled == is_enabled)
+        return;
+    display->is_reg_enabled = is_enabled;
+
     if (is_enabled)
         display->cmd_buffer[0] = SSD1306_CMD_DISPLAY_ON;
     else
@@ -439,6 +4018,10 @@ void ssd1306_display_enable(struct ssd1306_display *display, bool is_enabled) {
  */
 void ssd1306_display_fully_on(struct ssd1306_display *display,
                               bool is_enabled) {
+    if (display->is_reg_valid && display->is_reg_fully_on == is_enabled)
+        return;
+    display->is_reg_fully_on = is_enabled;
+
     if (is_enabled)
         display->cmd_buffer[0] = SSD1306_CMD_ENTIRE_DISPLAY_ON_ENABLED;
     else
@@ -457,6 +4040,10 @@ void ssd1306_display_fully_on(struct ssd1306_display *display,
  * @param is_enabled 'true' to enable; 'false' to disable.
  */
 void ssd1306_display_inverse(struct ssd1306_display *display, bool is_enabled) {
+    if (display->is_reg_valid && display->is_reg_inverse == is_enabled)
+        return;
+    display->is_reg_inverse = is_enabled;
+
     if (is_enabled)
         display->cmd_buffer[0] = SSD1306_CMD_INVERSE_ENABLED;
     else
@@ -470,11 +4057,18 @@ void ssd1306_display_inverse(struct ssd1306_display *display, bool is_enabled) {
  * @note
  * - When enabled, the display contents are shown horizontally mirrored.
  *
+ * - Only affects the subsequent data, so the display will be updated if the
+ * setting changes.
+ *
  * @param display Pointer to the ssd1306_display structure.
  * @param is_enabled 'true' to enable; 'false' to disable.
  */
 void ssd1306_display_mirror_h(struct ssd1306_display *display,
                               bool is_enabled) {
+    if (display->is_reg_valid && display->is_reg_mirror_h == is_enabled)
+        return;
+    display->is_reg_mirror_h = is_enabled;
+
     if (is_enabled)
         display->cmd_buffer[0] = SSD1306_CMD_SEGMENT_REMAP_ENABLED;
     else
@@ -482,7 +4076,11 @@ void ssd1306_display_mirror_h(struct ssd1306_display *display,
     h_send_cmd_buffer(display, 1);
 
     /* Only effects subsequent data */
-    ssd1306_display_update(display);
+    h_set_display_unknown(display);
+    if (display->is_cmd_batch)
+        display->is_update_pending = true;
+    else
+        ssd1306_display_update(display);
 }
 
 /**
@@ -496,6 +4094,10 @@ void ssd1306_display_mirror_h(struct ssd1306_display *display,
  */
 void ssd1306_display_mirror_v(struct ssd1306_display *display,
                               bool is_enabled) {
+    if (display->is_reg_valid && display->is_reg_mirror_v == is_enabled)
+        return;
+    display->is_reg_mirror_v = is_enabled;
+
     if (is_enabled)
         display->cmd_buffer[0] = SSD1306_CMD_SCAN_REMAP_ENABLED;
     else
@@ -511,7 +4113,9 @@ void ssd1306_display_mirror_v(struct ssd1306_display *display,
  *
  * - The display will be updated, and any subsequent updates will cause the
  * contents of the display to be corrupted. To prevent corruption, call
- * ssd1306_display_scroll_disable() before updating.
+ * ssd1306_display_scroll_disable() before updating. During a batch
+ * (ssd1306_display_batch_begin()), only an update postponed by the batch is
+ * done, so update the display before starting the batch.
  *
  * - Vertical scrolling is not supported.
  *
@@ -548,6 +4152,12 @@ void ssd1306_display_scroll_enable(struct ssd1306_display *display,
     /* Data-sheet p46 */
     ssd1306_display_scroll_disable(display);
 
+    /* The display must be rewritten before the scroll starts. Sends nothing
+     * if nothing has changed. During a batch, only a postponed update is
+     * done */
+    if (!display->is_cmd_batch || display->is_update_pending)
+        ssd1306_display_update(display);
+
     uint8_t *cmd_buffer = display->cmd_buffer;
     uint8_t cmd_length;
 
@@ -580,24 +4190,34 @@ void ssd1306_display_scroll_enable(struct ssd1306_display *display,
         cmd_length = 8;
     }
     h_send_cmd_buffer(display, cmd_length);
+    display->is_reg_scrolling = true;
 }
 
 /**
  * @brief Stops an ongoing scroll.
  *
  * @note
- * - The display will be updated (limitation of the driver chip).
+ * - The display will be updated (limitation of the driver chip). Does nothing
+ * if there's no ongoing scroll.
  *
  * - To start a scroll, call ssd1306_display_scroll_enable().
  *
  * @param display Pointer to the ssd1306_display structure.
  */
 void ssd1306_display_scroll_disable(struct ssd1306_display *display) {
+    if (display->is_reg_valid && !display->is_reg_scrolling)
+        return;
+    display->is_reg_scrolling = false;
+
     display->cmd_buffer[0] = SSD1306_CMD_SCROLL_DISABLE;
     h_send_cmd_buffer(display, 1);
 
     /* Data-sheet p46 */
-    ssd1306_display_update(display);
+    h_set_display_unknown(display);
+    if (display->is_cmd_batch)
+        display->is_update_pending = true;
+    else
+        ssd1306_display_update(display);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -608,7 +4228,7 @@ void ssd1306_display_scroll_disable(struct ssd1306_display *display) {
  * @brief Clears the entire buffer (all pixels off).
  *
  * @note
- * - Ignores buffer mode (draw/clear).
+ * - Ignores buffer mode (draw/clear/XOR).
  *
  * - Ignores draw border.
  *
@@ -618,21 +4238,16 @@ void ssd1306_display_scroll_disable(struct ssd1306_display *display) {
  * @param display Pointer to the ssd1306_display structure.
  */
 void ssd1306_draw_clear(struct ssd1306_display *display) {
-    uint16_t buffer_size;
-    if (display->display_type)
-        buffer_size = SSD1306_BUFFER_SIZE_64;
-    else
-        buffer_size = SSD1306_BUFFER_SIZE_32;
-    for (uint16_t i = 0; i < buffer_size; i++) {
-        display->data_buffer[i] = 0x00;
-    }
+    h_set_dirty_all(display);
+
+    memset(display->data_buffer, 0x00, h_get_buffer_size(display));
 }
 
 /**
  * @brief Fills the entire buffer (all pixels on).
  *
  * @note
- * - Ignores buffer mode (draw/clear).
+ * - Ignores buffer mode (draw/clear/XOR).
  *
  * - Ignores draw border.
  *
@@ -642,23 +4257,18 @@ void ssd1306_draw_clear(struct ssd1306_display *display) {
  * @param display Pointer to the ssd1306_display structure.
  */
 void ssd1306_draw_fill(struct ssd1306_display *display) {
-    uint16_t buffer_size;
-    if (display->display_type)
-        buffer_size = SSD1306_BUFFER_SIZE_64;
-    else
-        buffer_size = SSD1306_BUFFER_SIZE_32;
-    for (uint16_t i = 0; i < buffer_size; i++) {
-        display->data_buffer[i] = 0xFF;
-    }
+    h_set_dirty_all(display);
+
+    memset(display->data_buffer, 0xFF, h_get_buffer_size(display));
 }
 
 /**
  * @brief Inverts the entire buffer (all pixels flipped).
  *
  * @note
- * - Ignores buffer mode (draw/clear).
+ * - Ignores buffer mode (draw/clear/XOR).
  *
- * - Ignores draw border.
+ * - Ignores draw border, unless the transform mode is set to border.
  *
  * - Draw functions don't update the display. Don't forget to call the
  * ssd1306_display_update() to push the buffer onto the display.
@@ -666,23 +4276,25 @@ void ssd1306_draw_fill(struct ssd1306_display *display) {
  * @param display Pointer to the ssd1306_display structure.
  */
 void ssd1306_draw_invert(struct ssd1306_display *display) {
-    uint16_t buffer_size;
-    if (display->display_type)
-        buffer_size = SSD1306_BUFFER_SIZE_64;
-    else
-        buffer_size = SSD1306_BUFFER_SIZE_32;
-    for (uint16_t i = 0; i < buffer_size; i++) {
-        display->data_buffer[i] = ~display->data_buffer[i];
+    if (display->transform_mode == SSD1306_TRANSFORM_MODE_BORDER) {
+        uint8_t x_min, y_min, x_max, y_max;
+        if (h_get_transform_area(display, &x_min, &y_min, &x_max, &y_max))
+            h_invert_area(display, x_min, y_min, x_max, y_max);
+        return;
     }
+
+    h_set_dirty_all(display);
+
+    h_invert_bytes(display->data_buffer, h_get_buffer_size(display));
 }
 
 /**
  * @brief Horizontally mirrors the entire buffer.
  *
  * @note
- * - Ignores buffer mode (draw/clear).
+ * - Ignores buffer mode (draw/clear/XOR).
  *
- * - Ignores draw border.
+ * - Ignores draw border, unless the transform mode is set to border.
  *
  * - Draw functions don't update the display. Don't forget to call the
  * ssd1306_display_update() to push the buffer onto the display.
@@ -690,6 +4302,21 @@ void ssd1306_draw_invert(struct ssd1306_display *display) {
  * @param display Pointer to the ssd1306_display structure.
  */
 void ssd1306_draw_mirror_h(struct ssd1306_display *display) {
+    if (display->transform_mode == SSD1306_TRANSFORM_MODE_BORDER ||
+        h_is_portrait(display)) {
+        uint8_t x_min, y_min, x_max, y_max;
+        if (!h_get_transform_area(display, &x_min, &y_min, &x_max, &y_max))
+            return;
+        /* Portrait x/y are the native rows/columns */
+        if (h_is_portrait(display))
+            h_mirror_v_area(display, x_min, y_min, x_max, y_max);
+        else
+            h_mirror_h_area(display, x_min, y_min, x_max, y_max);
+        return;
+    }
+
+    h_set_dirty_all(display);
+
     uint8_t page_last;
     if (display->display_type)
         page_last = 7;
@@ -718,9 +4345,9 @@ void ssd1306_draw_mirror_h(struct ssd1306_display *display) {
  * @brief Vertically mirrors the entire buffer.
  *
  * @note
- * - Ignores buffer mode (draw/clear).
+ * - Ignores buffer mode (draw/clear/XOR).
  *
- * - Ignores draw border.
+ * - Ignores draw border, unless the transform mode is set to border.
  *
  * - Draw functions don't update the display. Don't forget to call the
  * ssd1306_display_update() to push the buffer onto the display.
@@ -728,6 +4355,21 @@ void ssd1306_draw_mirror_h(struct ssd1306_display *display) {
  * @param display Pointer to the ssd1306_display structure.
  */
 void ssd1306_draw_mirror_v(struct ssd1306_display *display) {
+    if (display->transform_mode == SSD1306_TRANSFORM_MODE_BORDER ||
+        h_is_portrait(display)) {
+        uint8_t x_min, y_min, x_max, y_max;
+        if (!h_get_transform_area(display, &x_min, &y_min, &x_max, &y_max))
+            return;
+        /* Portrait x/y are the native rows/columns */
+        if (h_is_portrait(display))
+            h_mirror_h_area(display, x_min, y_min, x_max, y_max);
+        else
+            h_mirror_v_area(display, x_min, y_min, x_max, y_max);
+        return;
+    }
+
+    h_set_dirty_all(display);
+
     uint8_t page_last;
     uint8_t swap_counter;
     if (display->display_type) {
@@ -738,20 +4380,19 @@ void ssd1306_draw_mirror_v(struct ssd1306_display *display) {
         swap_counter = 2;
     }
 
+    /* Swaps whole pages with their counterparts, reversing the bytes */
     uint8_t temp;
     uint8_t *byte_first_ptr;
     uint8_t *byte_last_ptr;
-    for (uint8_t i = 0; i <= SSD1306_X_MAX; i++) {
-        byte_first_ptr = &display->data_buffer[i];
-        byte_last_ptr = byte_first_ptr + SSD1306_PAGE_OFFSETS[page_last];
-
-        for (uint8_t i = 0; i < swap_counter; i++) {
-            temp = h_reverse_byte(*byte_first_ptr);
-            *byte_first_ptr = h_reverse_byte(*byte_last_ptr);
-            *byte_last_ptr = temp;
+    for (uint8_t page = 0; page < swap_counter; page++) {
+        byte_first_ptr = &display->data_buffer[SSD1306_PAGE_OFFSETS[page]];
+        byte_last_ptr =
+            &display->data_buffer[SSD1306_PAGE_OFFSETS[page_last - page]];
 
-            byte_first_ptr += SSD1306_PAGE1_OFFSET;
-            byte_last_ptr -= SSD1306_PAGE1_OFFSET;
+        for (uint8_t i = 0; i <= SSD1306_X_MAX; i++) {
+            temp = h_reverse_byte(byte_first_ptr[i]);
+            byte_first_ptr[i] = h_reverse_byte(byte_last_ptr[i]);
+            byte_last_ptr[i] = temp;
         }
     }
 }
@@ -760,7 +4401,7 @@ void ssd1306_draw_mirror_v(struct ssd1306_display *display) {
  * @brief Shifts the buffer contents to the right by one pixel.
  *
  * @note
- * - Ignores draw border.
+ * - Ignores draw border, unless the transform mode is set to border.
  *
  * - Draw functions don't update the display. Don't forget to call the
  * ssd1306_display_update() to push the buffer onto the display.
@@ -774,6 +4415,14 @@ void ssd1306_draw_mirror_v(struct ssd1306_display *display) {
  */
 void ssd1306_draw_shift_right(struct ssd1306_display *display,
                               bool is_rotated) {
+    if (display->transform_mode == SSD1306_TRANSFORM_MODE_BORDER ||
+        display->rotation != SSD1306_ROTATION_0) {
+        ssd1306_draw_shift_right_by(display, 1, is_rotated);
+        return;
+    }
+
+    h_set_dirty_all(display);
+
     uint8_t page_last;
     if (display->display_type)
         page_last = 7;
@@ -784,13 +4433,8 @@ void ssd1306_draw_shift_right(struct ssd1306_display *display,
     uint8_t *byte_ptr;
     for (uint8_t page = 0; page <= page_last; page++) {
         byte_ptr = &display->data_buffer[SSD1306_PAGE_OFFSETS[page]];
-        byte_ptr += SSD1306_X_MAX;
-        temp = *byte_ptr;
-
-        for (uint8_t i = 0; i < SSD1306_X_MAX; i++) {
-            *byte_ptr = *(byte_ptr - 1);
-            byte_ptr--;
-        }
+        temp = byte_ptr[SSD1306_X_MAX];
+        memmove(byte_ptr + 1, byte_ptr, SSD1306_X_MAX);
 
         if (is_rotated)
             *byte_ptr = temp;
@@ -805,7 +4449,7 @@ void ssd1306_draw_shift_right(struct ssd1306_display *display,
  * @brief Shifts the buffer contents to the left by one pixel.
  *
  * @note
- * - Ignores draw border.
+ * - Ignores draw border, unless the transform mode is set to border.
  *
  * - Draw functions don't update the display. Don't forget to call the
  * ssd1306_display_update() to push the buffer onto the display.
@@ -818,6 +4462,14 @@ void ssd1306_draw_shift_right(struct ssd1306_display *display,
  * mode.
  */
 void ssd1306_draw_shift_left(struct ssd1306_display *display, bool is_rotated) {
+    if (display->transform_mode == SSD1306_TRANSFORM_MODE_BORDER ||
+        display->rotation != SSD1306_ROTATION_0) {
+        ssd1306_draw_shift_left_by(display, 1, is_rotated);
+        return;
+    }
+
+    h_set_dirty_all(display);
+
     uint8_t page_last;
     if (display->display_type)
         page_last = 7;
@@ -829,11 +4481,8 @@ void ssd1306_draw_shift_left(struct ssd1306_display *display, bool is_rotated) {
     for (uint8_t page = 0; page <= page_last; page++) {
         byte_ptr = &display->data_buffer[SSD1306_PAGE_OFFSETS[page]];
         temp = *byte_ptr;
-
-        for (uint8_t i = 0; i < SSD1306_X_MAX; i++) {
-            *byte_ptr = *(byte_ptr + 1);
-            byte_ptr++;
-        }
+        memmove(byte_ptr, byte_ptr + 1, SSD1306_X_MAX);
+        byte_ptr += SSD1306_X_MAX;
 
         if (is_rotated)
             *byte_ptr = temp;
@@ -848,7 +4497,7 @@ void ssd1306_draw_shift_left(struct ssd1306_display *display, bool is_rotated) {
  * @brief Shifts the buffer contents upward by one pixel.
  *
  * @note
- * - Ignores draw border.
+ * - Ignores draw border, unless the transform mode is set to border.
  *
  * - Draw functions don't update the display. Don't forget to call the
  * ssd1306_display_update() to push the buffer onto the display.
@@ -861,51 +4510,14 @@ void ssd1306_draw_shift_left(struct ssd1306_display *display, bool is_rotated) {
  * mode.
  */
 void ssd1306_draw_shift_up(struct ssd1306_display *display, bool is_rotated) {
-    uint8_t page_last;
-    if (display->display_type)
-        page_last = 7;
-    else
-        page_last = 3;
-
-    uint8_t very_top_bit;
-    if (!is_rotated) {
-        if (display->buffer_mode)
-            very_top_bit = 0x00;
-        else
-            very_top_bit = 0x80;
-    }
-
-    uint8_t *byte_ptr;
-    uint8_t *byte_next_ptr;
-    uint8_t top_bit;
-    for (uint8_t i = 0; i <= SSD1306_X_MAX; i++) {
-        byte_ptr = &display->data_buffer[i];
-
-        if (is_rotated) {
-            if (*byte_ptr & 1)
-                very_top_bit = 0x80;
-            else
-                very_top_bit = 0x00;
-        }
-
-        for (uint8_t page = 0; page < page_last; page++) {
-            byte_next_ptr = byte_ptr + SSD1306_PAGE1_OFFSET;
-            if (*byte_next_ptr & 1)
-                top_bit = 0x80;
-            else
-                top_bit = 0x00;
-            *byte_ptr = (uint8_t)(*byte_ptr >> 1) + top_bit;
-            byte_ptr = byte_next_ptr;
-        }
-        *byte_ptr = (uint8_t)(*byte_ptr >> 1) + very_top_bit;
-    }
+    ssd1306_draw_shift_up_by(display, 1, is_rotated);
 }
 
 /**
  * @brief Shifts the buffer contents downward by one pixel.
  *
  * @note
- * - Ignores draw border.
+ * - Ignores draw border, unless the transform mode is set to border.
  *
  * - Draw functions don't update the display. Don't forget to call the
  * ssd1306_display_update() to push the buffer onto the display.
@@ -918,44 +4530,111 @@ void ssd1306_draw_shift_up(struct ssd1306_display *display, bool is_rotated) {
  * mode.
  */
 void ssd1306_draw_shift_down(struct ssd1306_display *display, bool is_rotated) {
-    uint8_t page_last;
-    if (display->display_type)
-        page_last = 7;
-    else
-        page_last = 3;
+    ssd1306_draw_shift_down_by(display, 1, is_rotated);
+}
 
-    uint8_t very_bottom_bit;
-    if (!is_rotated) {
-        if (display->buffer_mode)
-            very_bottom_bit = 0;
-        else
-            very_bottom_bit = 1;
-    }
+/**
+ * @brief Shifts the buffer contents to the right by the specified number of
+ * pixels.
+ *
+ * @note
+ * - Shifts in a single pass regardless of the number of pixels, much faster
+ * than calling ssd1306_draw_shift_right() repeatedly.
+ *
+ * - Ignores draw border, unless the transform mode is set to border.
+ *
+ * - Draw functions don't update the display. Don't forget to call the
+ * ssd1306_display_update() to push the buffer onto the display.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param count Number of pixels to shift by.
+ * @param is_rotated 'true' to enable rotation; 'false' to just shift. When
+ * rotation is enabled, pixels that shift off-screen reappear on the opposite
+ * side. When rotation is disabled, pixels that shift off-screen are clipped,
+ * and the value for new pixels entering the screen is determined by the buffer
+ * mode.
+ */
+void ssd1306_draw_shift_right_by(struct ssd1306_display *display, uint8_t count,
+                                 bool is_rotated) {
+    h_shift(display, (int16_t)count, false, is_rotated);
+}
 
-    uint8_t *byte_ptr;
-    uint8_t *byte_next_ptr;
-    uint8_t bottom_bit;
-    for (uint8_t i = 0; i <= SSD1306_X_MAX; i++) {
-        byte_ptr = &display->data_buffer[i] + SSD1306_PAGE_OFFSETS[page_last];
-
-        if (is_rotated) {
-            if (*byte_ptr & 0x80)
-                very_bottom_bit = 1;
-            else
-                very_bottom_bit = 0;
-        }
+/**
+ * @brief Shifts the buffer contents to the left by the specified number of
+ * pixels.
+ *
+ * @note
+ * - Shifts in a single pass regardless of the number of pixels, much faster
+ * than calling ssd1306_draw_shift_left() repeatedly.
+ *
+ * - Ignores draw border, unless the transform mode is set to border.
+ *
+ * - Draw functions don't update the display. Don't forget to call the
+ * ssd1306_display_update() to push the buffer onto the display.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param count Number of pixels to shift by.
+ * @param is_rotated 'true' to enable rotation; 'false' to just shift. When
+ * rotation is enabled, pixels that shift off-screen reappear on the opposite
+ * side. When rotation is disabled, pixels that shift off-screen are clipped,
+ * and the value for new pixels entering the screen is determined by the buffer
+ * mode.
+ */
+void ssd1306_draw_shift_left_by(struct ssd1306_display *display, uint8_t count,
+                                bool is_rotated) {
+    h_shift(display, -(int16_t)count, false, is_rotated);
+}
 
-        for (uint8_t page = 0; page < page_last; page++) {
-            byte_next_ptr = byte_ptr - SSD1306_PAGE1_OFFSET;
-            if (*byte_next_ptr & 0x80)
-                bottom_bit = 1;
-            else
-                bottom_bit = 0;
-            *byte_ptr = (uint8_t)(*byte_ptr << 1) + bottom_bit;
-            byte_ptr = byte_next_ptr;
-        }
-        *byte_ptr = (uint8_t)(*byte_ptr << 1) + very_bottom_bit;
-    }
+/**
+ * @brief Shifts the buffer contents upward by the specified number of
+ * pixels.
+ *
+ * @note
+ * - Shifts in a single pass regardless of the number of pixels, much faster
+ * than calling ssd1306_draw_shift_up() repeatedly.
+ *
+ * - Ignores draw border, unless the transform mode is set to border.
+ *
+ * - Draw functions don't update the display. Don't forget to call the
+ * ssd1306_display_update() to push the buffer onto the display.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param count Number of pixels to shift by.
+ * @param is_rotated 'true' to enable rotation; 'false' to just shift. When
+ * rotation is enabled, pixels that shift off-screen reappear on the opposite
+ * side. When rotation is disabled, pixels that shift off-screen are clipped,
+ * and the value for new pixels entering the screen is determined by the buffer
+ * mode.
+ */
+void ssd1306_draw_shift_up_by(struct ssd1306_display *display, uint8_t count,
+                              bool is_rotated) {
+    h_shift(display, -(int16_t)count, true, is_rotated);
+}
+
+/**
+ * @brief Shifts the buffer contents downward by the specified number of
+ * pixels.
+ *
+ * @note
+ * - Shifts in a single pass regardless of the number of pixels, much faster
+ * than calling ssd1306_draw_shift_down() repeatedly.
+ *
+ * - Ignores draw border, unless the transform mode is set to border.
+ *
+ * - Draw functions don't update the display. Don't forget to call the
+ * ssd1306_display_update() to push the buffer onto the display.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param count Number of pixels to shift by.
+ * @param is_rotated 'true' to enable rotation; 'false' to just shift. When
+ * rotation is enabled, pixels that shift off-screen reappear on the opposite
+ * side. When rotation is disabled, pixels that shift off-screen are clipped,
+ * and the value for new pixels entering the screen is determined by the buffer
+ * mode.
+ */
+void ssd1306_draw_shift_down_by(struct ssd1306_display *display, uint8_t count,
+                                bool is_rotated) {
+    h_shift(display, (int16_t)count, true, is_rotated);
 }
 
 /**
@@ -977,14 +4656,19 @@ void ssd1306_draw_shift_down(struct ssd1306_display *display, bool is_rotated) {
 void ssd1306_draw_pixel(struct ssd1306_display *display, int16_t x, int16_t y) {
     if (!h_are_coords_in_border(display, x, y))
         return;
+    if (display->rotation != SSD1306_ROTATION_0)
+        h_map_point(display, &x, &y);
 
     /* x > 0 and y > 0 after above check */
     uint16_t index = SSD1306_PAGE_OFFSETS[y >> 3] + (uint16_t)x;
     uint8_t mask = (uint8_t)(1 << (y & 7));
-    if (display->buffer_mode)
+    if (display->buffer_mode == SSD1306_BUFFER_MODE_XOR)
+        display->data_buffer[index] ^= mask;
+    else if (display->buffer_mode)
         display->data_buffer[index] |= mask;
     else
         display->data_buffer[index] &= ~mask;
+    h_set_dirty(display, (uint8_t)(y >> 3), (uint8_t)x, (uint8_t)x);
 }
 
 /**
@@ -1008,18 +4692,10 @@ void ssd1306_draw_pixel(struct ssd1306_display *display, int16_t x, int16_t y) {
  */
 void ssd1306_draw_line_h(struct ssd1306_display *display, int16_t x0,
                          int16_t y0, int16_t width) {
-    int16_t xi;
-    if (width < 0) {
-        width = -width;
-        xi = -1;
-    } else {
-        xi = 1;
-    }
-
-    for (; width > 0; width--) {
-        ssd1306_draw_pixel(display, x0, y0);
-        x0 += xi;
-    }
+    if (width < 0)
+        h_draw_span_h(display, (int32_t)x0 + width + 1, x0, y0);
+    else
+        h_draw_span_h(display, x0, (int32_t)x0 + width - 1, y0);
 }
 
 /**
@@ -1043,18 +4719,10 @@ void ssd1306_draw_line_h(struct ssd1306_display *display, int16_t x0,
  */
 void ssd1306_draw_line_v(struct ssd1306_display *display, int16_t x0,
                          int16_t y0, int16_t height) {
-    int16_t yi;
-    if (height < 0) {
-        height = -height;
-        yi = -1;
-    } else {
-        yi = 1;
-    }
-
-    for (; height > 0; height--) {
-        ssd1306_draw_pixel(display, x0, y0);
-        y0 += yi;
-    }
+    if (height < 0)
+        h_draw_span_v(display, x0, (int32_t)y0 + height + 1, y0);
+    else
+        h_draw_span_v(display, x0, y0, (int32_t)y0 + height - 1);
 }
 
 /**
@@ -1077,58 +4745,121 @@ void ssd1306_draw_line_v(struct ssd1306_display *display, int16_t x0,
  */
 void ssd1306_draw_line(struct ssd1306_display *display, int16_t x0, int16_t y0,
                        int16_t x1, int16_t y1) {
-    int16_t dx, dy, D, yi, temp;
-    uint8_t is_swapped;
+    int32_t u0, v0, u1, v1, du, dv, D, vi, u_min, u_max, v_min, v_max, temp;
+    bool is_swapped;
 
-    /* Swap coordinates if slope > 1 (compensated when drawing) */
-    dx = x1 - x0;
-    dy = y1 - y0;
-    if (dx < 0)
-        dx = -dx;
-    if (dy < 0)
-        dy = -dy;
-    if (dy > dx) {
-        temp = x0;
-        x0 = y0;
-        y0 = temp;
-        temp = x1;
-        x1 = y1;
-        y1 = temp;
+    if (h_is_box_outside_border(display, (x0 < x1) ? x0 : x1,
+                                (y0 < y1) ? y0 : y1, (x0 > x1) ? x0 : x1,
+                                (y0 > y1) ? y0 : y1))
+        return;
+
+    /* Step along the major axis 'u' (compensated when drawing) */
+    du = (int32_t)x1 - x0;
+    dv = (int32_t)y1 - y0;
+    if (du < 0)
+        du = -du;
+    if (dv < 0)
+        dv = -dv;
+    if (dv > du) {
+        u0 = y0;
+        v0 = x0;
+        u1 = y1;
+        v1 = x1;
+        u_min = display->border_y_min;
+        u_max = display->border_y_max;
+        v_min = display->border_x_min;
+        v_max = display->border_x_max;
         is_swapped = true;
     } else {
+        u0 = x0;
+        v0 = y0;
+        u1 = x1;
+        v1 = y1;
+        u_min = display->border_x_min;
+        u_max = display->border_x_max;
+        v_min = display->border_y_min;
+        v_max = display->border_y_max;
         is_swapped = false;
     }
 
-    /* Make sure x0 < x1 */
-    if (x0 > x1) {
-        temp = x0;
-        x0 = x1;
-        x1 = temp;
-        temp = y0;
-        y0 = y1;
-        y1 = temp;
+    /* Make sure u0 < u1 */
+    if (u0 > u1) {
+        temp = u0;
+        u0 = u1;
+        u1 = temp;
+        temp = v0;
+        v0 = v1;
+        v1 = temp;
     }
 
-    /* Draw the line */
-    dx = x1 - x0;
-    dy = y1 - y0;
-    D = -((uint16_t)dx >> 1); /* In case not optimized, dx is always > 0 */
-    if (dy < 0) {
-        yi = -1;
-        dy = -dy;
+    du = u1 - u0;
+    dv = v1 - v0;
+    D = -(du >> 1);
+    if (dv < 0) {
+        vi = -1;
+        dv = -dv;
     } else {
-        yi = 1;
+        vi = 1;
+    }
+
+    /*
+     * Clip the major axis against the border. The skipped steps are jumped
+     * over in one go: after 'k' steps, the line has moved
+     * n = ceil((k * dv - du / 2) / du) pixels along the minor axis, and the
+     * error term is the remainder. This keeps the pixels identical to
+     * iterating from the first point.
+     */
+    if (u1 > u_max)
+        u1 = u_max;
+    if (u0 < u_min) {
+        int64_t num = (int64_t)(u_min - u0) * dv + D;
+        int32_t n = 0;
+        if (num > 0)
+            n = (int32_t)((num + du - 1) / du);
+        D = (int32_t)(num - (int64_t)n * du);
+        v0 += vi * n;
+        u0 = u_min;
+    }
+
+    /* Horizontal/vertical lines are a single run */
+    if (dv == 0) {
+        if (is_swapped)
+            h_draw_span_v(display, v0, u0, u1);
+        else
+            h_draw_span_h(display, u0, u1, v0);
+        return;
     }
-    for (; x0 <= x1; x0++) {
+
+    /*
+     * Draw the line run by run. A run continues along the major axis until
+     * the error term turns positive, so its length is '-D / dv + 1'. After
+     * the first run, every run is either 'du / dv' or 'du / dv + 1' pixels
+     * long, so only the first one needs a division. Stop once the line leaves
+     * the border along the minor axis.
+     */
+    int32_t run_short = du / dv;
+    int32_t run_short_error = run_short * dv;
+    int32_t error = -D; /* In [0, du) at the start of every run */
+    int32_t run = error / dv + 1;
+    for (;;) {
+        int32_t u_end = u0 + run - 1;
+        if (u_end > u1)
+            u_end = u1;
         if (is_swapped)
-            ssd1306_draw_pixel(display, y0, x0);
+            h_draw_span_v(display, v0, u0, u_end);
         else
-            ssd1306_draw_pixel(display, x0, y0);
-        D += dy;
-        if (D > 0) {
-            D -= dx;
-            y0 += yi;
-        }
+            h_draw_span_h(display, u0, u_end, v0);
+        if (u_end == u1)
+            break;
+
+        u0 += run;
+        error += du - run * dv;
+        v0 += vi;
+        if ((v0 < v_min && vi < 0) || (v0 > v_max && vi > 0))
+            break;
+        run = run_short;
+        if (error >= run_short_error)
+            run++;
     }
 }
 
@@ -1155,6 +4886,15 @@ void ssd1306_draw_line(struct ssd1306_display *display, int16_t x0, int16_t y0,
 void ssd1306_draw_triangle(struct ssd1306_display *display, int16_t x0,
                            int16_t y0, int16_t x1, int16_t y1, int16_t x2,
                            int16_t y2) {
+    if (h_is_triangle_outside_border(display, x0, y0, x1, y1, x2, y2))
+        return;
+
+    if (display->buffer_mode == SSD1306_BUFFER_MODE_XOR) {
+        int16_t points[6] = {x0, y0, x1, y1, x2, y2};
+        ssd1306_draw_polygon(display, points, 3);
+        return;
+    }
+
     ssd1306_draw_line(display, x0, y0, x1, y1);
     ssd1306_draw_line(display, x1, y1, x2, y2);
     ssd1306_draw_line(display, x2, y2, x0, y0);
@@ -1183,10 +4923,11 @@ void ssd1306_draw_triangle(struct ssd1306_display *display, int16_t x0,
 void ssd1306_draw_triangle_fill(struct ssd1306_display *display, int16_t x0,
                                 int16_t y0, int16_t x1, int16_t y1, int16_t x2,
                                 int16_t y2) {
-    int16_t dx01, dy01, dx02, dy02, dx12, dy12;
-    int16_t y, xa, xb, dxa, dxb, width;
     int16_t temp;
 
+    if (h_is_triangle_outside_border(display, x0, y0, x1, y1, x2, y2))
+        return;
+
     /* Sort the coordinates by y position */
     if (y0 > y1) {
         temp = y0;
@@ -1213,78 +4954,282 @@ void ssd1306_draw_triangle_fill(struct ssd1306_display *display, int16_t x0,
         x1 = temp;
     }
 
-    /*
-     * Find the left most and right most coordinates
-     * If all coordinates are on the same line, return to avoid /0
-     */
+    /* If all coordinates are on the same line, draw from left to right most */
     if (y0 == y2) {
-        if (x0 < x1) {
-            xa = x0;
-            xb = x1;
-        } else {
+        int16_t xa = x0, xb = x0;
+        if (x1 < xa)
             xa = x1;
-            xb = x0;
-        }
-
+        if (x1 > xb)
+            xb = x1;
         if (x2 < xa)
             xa = x2;
         if (x2 > xb)
             xb = x2;
 
-        ssd1306_draw_line_h(display, xa, y0, xb - xa + 1);
+        h_draw_span_h(display, xa, xb, y0);
         return;
     }
 
-    /* Initialize the deltas */
-    dx01 = x1 - x0;
-    dy01 = y1 - y0;
-    dx02 = x2 - x0;
-    dy02 = y2 - y0;
-    dx12 = x2 - x1;
-    dy12 = y2 - y1;
+    /* Only step through the rows within the border */
+    int32_t y = y0;
+    int32_t y_last = y2;
+    if (y < display->border_y_min)
+        y = display->border_y_min;
+    if (y_last > display->border_y_max)
+        y_last = display->border_y_max;
 
     /*
-     * Draw the upper triangle (flat bottom)
-     * (if y0 == y1, loop is skipped so no /0)
+     * Draw the upper triangle (flat bottom) between the 0-1 and 0-2 edges
      * (if y1 == y2, draw the y1 line as well)
      */
+    struct ssd1306_edge edge_a, edge_b;
+    int32_t y_split = y1;
     if (y1 == y2)
-        y1++;
-    dxa = 0;
-    dxb = 0;
-    for (y = y0; y < y1; y++) {
-        xa = x0 + (dxa / dy01);
-        xb = x0 + (dxb / dy02);
-        dxa += dx01;
-        dxb += dx02;
-
-        width = xb - xa;
-        if (width < 0)
-            width--;
-        else
-            width++;
-        ssd1306_draw_line_h(display, xa, y, width);
+        y_split++;
+    h_init_edge(&edge_b, x0, y0, x2, y2, y);
+    if (y < y_split) {
+        h_init_edge(&edge_a, x0, y0, x1, y1, y);
+        for (; (y < y_split) && (y <= y_last); y++) {
+            h_draw_span_between(display, edge_a.x, edge_b.x, y);
+            h_step_edge(&edge_a);
+            h_step_edge(&edge_b);
+        }
     }
 
-    /*
-     * Draw the lower triangle (flat top)
-     * If y1 == y2, line is already drawn above, so return
-     */
-    if (y1 == y2)
+    /* Draw the lower triangle (flat top) between the 1-2 and 0-2 edges */
+    if (y > y_last)
         return;
-    dxa = 0;
-    for (; y <= y2; y++) {
-        xa = x1 + (dxa / dy12);
-        xb = x0 + (dxb / dy02);
-        dxa += dx12;
-        dxb += dx02;
-
-        width = xb - xa;
-        if (width < 0)
-            width--;
-        else
-            width++;
-        ssd1306_draw_line_h(display, xa, y, width);
+    h_init_edge(&edge_a, x1, y1, x2, y2, y);
+    for (; y <= y_last; y++) {
+        h_draw_span_between(display, edge_a.x, edge_b.x, y);
+        h_step_edge(&edge_a);
+        h_step_edge(&edge_b);
+    }
+}
+
+/**
+ * @brief Draws a polygon connecting the specified points in order, and the last
+ * point back to the first one.
+ *
+ * @note
+ * - Clears the pixels instead if the buffer is in clear mode.
+ *
+ * - Drawing outside the border is allowed, but pixels that are out of bounds
+ * will be clipped.
+ *
+ * - Draw functions don't update the display. Don't forget to call the
+ * ssd1306_display_update() to push the buffer onto the display.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param points Pointer to the xy-coordinates of the points, in the order of
+ * {x0, y0, x1, y1, ...}. MUST hold "count * 2" values.
+ * @param count Number of points.
+ */
+void ssd1306_draw_polygon(struct ssd1306_display *display,
+                          const int16_t *points, uint8_t count) {
+    if (count == 0)
+        return;
+
+    if (display->buffer_mode == SSD1306_BUFFER_MODE_XOR) {
+        h_draw_outline_xor(display, points, count);
+        return;
+    }
+
+    int16_t x0 = points[((count - 1) << 1)];
+    int16_t y0 = points[((count - 1) << 1) + 1];
+    for (uint8_t i = 0; i < count; i++) {
+        int16_t x1 = points[i << 1];
+        int16_t y1 = points[(i << 1) + 1];
+        ssd1306_draw_line(display, x0, y0, x1, y1);
+        x0 = x1;
+        y0 = y1;
+    }
+}
+
+/**
+ * @brief Draws a filled polygon connecting the specified points in order, and
+ * the last point back to the first one.
+ *
+ * @note
+ * - Clears the pixels instead if the buffer is in clear mode.
+ *
+ * - Drawing outside the border is allowed, but pixels that are out of bounds
+ * will be clipped.
+ *
+ * - Each pixel is drawn once, so concave and self-intersecting shapes
+ * (needles, arrows, stars, etc.) can be drawn in a single call, rather than as
+ * overlapping triangles.
+ *
+ * - Polygons with more than SSD1306_POLYGON_VERTEX_LIMIT points are ignored.
+ *
+ * - Draw functions don't update the display. Don't forget to call the
+ * ssd1306_display_update() to push the buffer onto the display.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param points Pointer to the xy-coordinates of the points, in the order of
+ * {x0, y0, x1, y1, ...}. MUST hold "count * 2" values.
+ * @param count Number of points.
+ * @param rule Fill rule for the self-intersecting parts of the polygon.
+ */
+void ssd1306_draw_polygon_fill(struct ssd1306_display *display,
+                               const int16_t *points, uint8_t count,
+                               enum ssd1306_fill_rule rule) {
+    struct ssd1306_band band;
+    struct ssd1306_polygon_edge edges[SSD1306_POLYGON_VERTEX_LIMIT];
+    uint8_t active[SSD1306_POLYGON_VERTEX_LIMIT];
+    int16_t span_x_min[SSD1306_POLYGON_VERTEX_LIMIT];
+    int16_t span_x_max[SSD1306_POLYGON_VERTEX_LIMIT];
+
+    if ((count == 0) || (count > SSD1306_POLYGON_VERTEX_LIMIT))
+        return;
+
+    /* Build the edge table, sorted by the top row */
+    int16_t y_min = points[1], y_max = points[1];
+    int16_t x_min = points[0], x_max = points[0];
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t j = (i + 1 == count) ? 0 : i + 1;
+        int16_t xa = points[i << 1], ya = points[(i << 1) + 1];
+        int16_t xb = points[j << 1], yb = points[(j << 1) + 1];
+        if (xa < x_min)
+            x_min = xa;
+        if (xa > x_max)
+            x_max = xa;
+        if (ya < y_min)
+            y_min = ya;
+        if (ya > y_max)
+            y_max = ya;
+
+        struct ssd1306_polygon_edge edge;
+        if (ya == yb) {
+            edge.winding = 0;
+            edge.x_top = (xa < xb) ? xa : xb;
+            edge.x_bottom = (xa < xb) ? xb : xa;
+            edge.y_top = ya;
+            edge.y_bottom = ya;
+            edge.y_last = ya;
+        } else {
+            if (ya < yb) {
+                edge.winding = 1;
+                edge.x_top = xa;
+                edge.y_top = ya;
+                edge.x_bottom = xb;
+                edge.y_bottom = yb;
+            } else {
+                edge.winding = -1;
+                edge.x_top = xb;
+                edge.y_top = yb;
+                edge.x_bottom = xa;
+                edge.y_bottom = ya;
+            }
+            edge.y_last = edge.y_bottom;
+            if (h_is_polygon_edge_continued(points, count, i))
+                edge.y_last--;
+        }
+
+        uint8_t k = i;
+        for (; (k > 0) && (edges[k - 1].y_top > edge.y_top); k--)
+            edges[k] = edges[k - 1];
+        edges[k] = edge;
+    }
+
+    if (h_is_box_outside_border(display, x_min, y_min, x_max, y_max))
+        return;
+
+    /* Only step through the rows within the border */
+    int32_t y = y_min;
+    if (y < display->border_y_min)
+        y = display->border_y_min;
+    if (y_max > display->border_y_max)
+        y_max = display->border_y_max;
+
+    uint8_t next = 0, active_count = 0;
+    h_init_band(&band);
+    for (; y <= y_max; y++) {
+        uint8_t span_count = 0;
+
+        /* Drop the edges that ended */
+        uint8_t kept = 0;
+        for (uint8_t a = 0; a < active_count; a++) {
+            if (edges[active[a]].y_last >= y)
+                active[kept++] = active[a];
+        }
+        active_count = kept;
+
+        /* Add the edges that start (horizontal ones only add their span) */
+        for (; (next < count) && (edges[next].y_top <= y); next++) {
+            struct ssd1306_polygon_edge *edge = &edges[next];
+            if (edge->y_last < y)
+                continue;
+            if (edge->winding == 0) {
+                span_x_min[span_count] = edge->x_top;
+                span_x_max[span_count] = edge->x_bottom;
+                span_count++;
+                continue;
+            }
+            h_init_edge(&edge->edge, edge->x_top, edge->y_top, edge->x_bottom,
+                        edge->y_bottom, y);
+            active[active_count++] = next;
+        }
+
+        /* Sort the active edges by x, they barely move between rows */
+        for (uint8_t a = 1; a < active_count; a++) {
+            uint8_t index = active[a];
+            int32_t x = edges[index].edge.x;
+            uint8_t b = a;
+            for (; (b > 0) && (edges[active[b - 1]].edge.x > x); b--)
+                active[b] = active[b - 1];
+            active[b] = index;
+        }
+
+        /* Find the spans that are inside, and move the edges to the next row */
+        int16_t winding = 0;
+        int16_t x_start = 0;
+        for (uint8_t a = 0; a < active_count; a++) {
+            struct ssd1306_polygon_edge *edge = &edges[active[a]];
+            bool was_inside, is_inside;
+            if (rule == SSD1306_FILL_RULE_NON_ZERO) {
+                was_inside = (winding != 0);
+                winding += edge->winding;
+                is_inside = (winding != 0);
+            } else {
+                was_inside = (winding & 1);
+                winding++;
+                is_inside = (winding & 1);
+            }
+
+            if (!was_inside && is_inside) {
+                x_start = (int16_t)edge->edge.x;
+            } else if (was_inside && !is_inside) {
+                span_x_min[span_count] = x_start;
+                span_x_max[span_count] = (int16_t)edge->edge.x;
+                span_count++;
+            }
+            h_step_edge(&edge->edge);
+        }
+
+        /* Merge the spans, so that overlapping pixels are only drawn once */
+        for (uint8_t a = 1; a < span_count; a++) {
+            int16_t temp_min = span_x_min[a], temp_max = span_x_max[a];
+            uint8_t b = a;
+            for (; (b > 0) && (span_x_min[b - 1] > temp_min); b--) {
+                span_x_min[b] = span_x_min[b - 1];
+                span_x_max[b] = span_x_max[b - 1];
+            }
+            span_x_min[b] = temp_min;
+            span_x_max[b] = temp_max;
+        }
+        for (uint8_t a = 0; a < span_count;) {
+            int16_t span_min = span_x_min[a], span_max = span_x_max[a];
+            for (a++; a < span_count; a++) {
+                if (span_x_min[a] > span_max + 1)
+                    break;
+                if (span_x_max[a] > span_max)
+                    span_max = span_x_max[a];
+            }
+            h_add_band_span(display, &band, span_min, span_max,
+                            (int16_t)y);
+        }
+        h_end_band_row(display, &band, (int16_t)y, y_max);
     }
 }
 
@@ -1322,10 +5267,16 @@ void ssd1306_draw_rect(struct ssd1306_display *display, int16_t x0, int16_t y0,
         height = -height;
         y0 -= (height - 1);
     }
-    ssd1306_draw_line_h(display, x0, y0, width);
-    ssd1306_draw_line_h(display, x0, y0 + height - 1, width);
-    ssd1306_draw_line_v(display, x0, y0, height);
-    ssd1306_draw_line_v(display, x0 + width - 1, y0, height);
+
+    /* The sides don't overlap, each pixel is drawn once */
+    int32_t x_max = (int32_t)x0 + width - 1;
+    int32_t y_max = (int32_t)y0 + height - 1;
+    h_draw_span_h(display, x0, x_max, y0);
+    if (height > 1)
+        h_draw_span_h(display, x0, x_max, y_max);
+    h_draw_span_v(display, x0, (int32_t)y0 + 1, y_max - 1);
+    if (width > 1)
+        h_draw_span_v(display, x_max, (int32_t)y0 + 1, y_max - 1);
 }
 
 /**
@@ -1351,19 +5302,22 @@ void ssd1306_draw_rect(struct ssd1306_display *display, int16_t x0, int16_t y0,
  */
 void ssd1306_draw_rect_fill(struct ssd1306_display *display, int16_t x0,
                             int16_t y0, int16_t width, int16_t height) {
+    int32_t x_min = x0;
+    int32_t y_min = y0;
+    int32_t x_max = (int32_t)x0 + width - 1;
+    int32_t y_max = (int32_t)y0 + height - 1;
     if (width < 0) {
-        width = -width;
-        x0 -= (width - 1);
+        x_min = (int32_t)x0 + width + 1;
+        x_max = x0;
     }
     if (height < 0) {
-        height = -height;
-        y0 -= (height - 1);
+        y_min = (int32_t)y0 + height + 1;
+        y_max = y0;
     }
+    if ((width == 0) || (height == 0))
+        return;
 
-    while (height > 0) {
-        height--;
-        ssd1306_draw_line_h(display, x0, y0 + height, width);
-    }
+    h_fill_rect(display, x_min, y_min, x_max, y_max);
 }
 
 /**
@@ -1405,6 +5359,10 @@ void ssd1306_draw_rect_round(struct ssd1306_display *display, int16_t x0,
         y0 -= (height - 1);
     }
 
+    if (h_is_box_outside_border(display, x0, y0, (int32_t)x0 + width - 1,
+                                (int32_t)y0 + height - 1))
+        return;
+
     int16_t r_max;
     if (width < height)
         r_max = width >> 1; /* Width is always positive */
@@ -1416,6 +5374,24 @@ void ssd1306_draw_rect_round(struct ssd1306_display *display, int16_t x0,
     else if (r > r_max)
         r = r_max;
 
+    if (display->buffer_mode == SSD1306_BUFFER_MODE_XOR) {
+        /* The corners include the ends of the sides, each pixel is toggled
+         * once */
+        int32_t x_left = (int32_t)x0 + r;
+        int32_t y_top = (int32_t)y0 + r;
+        int32_t x_right = (int32_t)x0 + width - r - 1;
+        int32_t y_bottom = (int32_t)y0 + height - r - 1;
+        h_draw_round_outline(display, x_left, y_top, x_right, y_bottom, r,
+                             0b1111);
+        h_draw_span_h(display, x_left + 1, x_right - 1, y0);
+        if (height > 1)
+            h_draw_span_h(display, x_left + 1, x_right - 1, y_bottom + r);
+        h_draw_span_v(display, x0, y_top + 1, y_bottom - 1);
+        if (width > 1)
+            h_draw_span_v(display, x_right + r, y_top + 1, y_bottom - 1);
+        return;
+    }
+
     int16_t width_h = width - r - r;
     int16_t height_v = height - r - r;
     ssd1306_draw_arc(display, x0 + width - r - 1, y0 + r, r, 0x01);
@@ -1479,23 +5455,9 @@ void ssd1306_draw_rect_round_fill(struct ssd1306_display *display, int16_t x0,
     else if (r > r_max)
         r = r_max;
 
-    int16_t width_h = width - r - r;
-    int16_t height_v = height - r - r;
-    ssd1306_draw_arc_fill(display, x0 + width - r - 1, y0 + r, r, 0x1);
-    ssd1306_draw_arc_fill(display, x0 + r, y0 + r, r, 0x2);
-    ssd1306_draw_arc_fill(display, x0 + r, y0 + height - r - 1, r, 0x4);
-    ssd1306_draw_arc_fill(display, x0 + width - r - 1, y0 + height - r - 1, r,
-                          0x8);
-
-    for (int16_t i = 0; i <= r; i++) {
-        ssd1306_draw_line_h(display, x0 + r, y0 + i, width_h);
-    }
-    for (int16_t i = 0; i <= r; i++) {
-        ssd1306_draw_line_h(display, x0 + r, y0 + height - 1 - i, width_h);
-    }
-    for (int16_t i = 0; i < height_v; i++) {
-        ssd1306_draw_line_h(display, x0, y0 + r + i, width);
-    }
+    h_fill_round_box(display, (int32_t)x0 + r, (int32_t)y0 + r,
+                     (int32_t)x0 + width - r - 1, (int32_t)y0 + height - r - 1,
+                     r, 0b1111);
 }
 
 /**
@@ -1523,8 +5485,13 @@ void ssd1306_draw_rect_round_fill(struct ssd1306_display *display, int16_t x0,
  */
 void ssd1306_draw_arc(struct ssd1306_display *display, int16_t x0, int16_t y0,
                       int16_t r, uint8_t quadrants) {
-    if (r < 0)
+    if (r < 0 || h_is_arc_outside_border(display, x0, y0, r, quadrants))
+        return;
+
+    if (display->buffer_mode == SSD1306_BUFFER_MODE_XOR) {
+        h_draw_round_outline(display, x0, y0, x0, y0, r, quadrants);
         return;
+    }
 
     if (quadrants & 0b1100)
         ssd1306_draw_pixel(display, x0, y0 + r);
@@ -1602,61 +5569,10 @@ void ssd1306_draw_arc(struct ssd1306_display *display, int16_t x0, int16_t y0,
  */
 void ssd1306_draw_arc_fill(struct ssd1306_display *display, int16_t x0,
                            int16_t y0, int16_t r, uint8_t quadrants) {
-    if (r < 0)
+    if (r < 0 || h_is_arc_outside_border(display, x0, y0, r, quadrants))
         return;
 
-    if (quadrants & 0b1100)
-        ssd1306_draw_line_v(display, x0, y0, r + 1);
-    if (quadrants & 0b0011)
-        ssd1306_draw_line_v(display, x0, y0, -r - 1);
-    if (quadrants & 0b1001)
-        ssd1306_draw_line_h(display, x0, y0, r + 1);
-    if (quadrants & 0b0110)
-        ssd1306_draw_line_h(display, x0, y0, -r - 1);
-
-    int16_t f_middle, delta_e, delta_se, x, y;
-    int16_t diff_1, diff_2;
-
-    /* Initialize the middle point and delta values, start from (0, r) */
-    f_middle = 1 - r; /* Simplified from "5/4-r" */
-    delta_e = 3;
-    delta_se = -(r + r) + 5;
-    x = 0;
-    y = r;
-
-    /* Iterate from the top of the circle to the x=y line */
-    while (x < y) {
-        if (f_middle < 0) {
-            f_middle += delta_e;
-            delta_se += 2;
-        } else {
-            f_middle += delta_se;
-            delta_se += 4;
-            y--;
-        }
-        delta_e += 2;
-        x++;
-
-        /* Draw using 8-way symmetry */
-        diff_1 = y - x + 1;
-        diff_2 = -y + x - 1;
-        if (quadrants & 0b0001) {
-            ssd1306_draw_line_v(display, (x0 + x), (y0 - y), diff_1);
-            ssd1306_draw_line_h(display, (x0 + y), (y0 - x), diff_2);
-        }
-        if (quadrants & 0b0010) {
-            ssd1306_draw_line_v(display, (x0 - x), (y0 - y), diff_1);
-            ssd1306_draw_line_h(display, (x0 - y), (y0 - x), diff_1);
-        }
-        if (quadrants & 0b0100) {
-            ssd1306_draw_line_v(display, (x0 - x), (y0 + y), diff_2);
-            ssd1306_draw_line_h(display, (x0 - y), (y0 + x), diff_1);
-        }
-        if (quadrants & 0b1000) {
-            ssd1306_draw_line_v(display, (x0 + x), (y0 + y), diff_2);
-            ssd1306_draw_line_h(display, (x0 + y), (y0 + x), diff_2);
-        }
-    }
+    h_fill_round_box(display, x0, y0, x0, y0, r, quadrants);
 }
 
 /**
@@ -1736,7 +5652,7 @@ void ssd1306_draw_circle_fill(struct ssd1306_display *display, int16_t x0,
  * be accessed. For example, for an image with a resolution of 60x40, the
  * height value should be '40'.
  * @param has_bg 'true' to overwrite the contents in the background; 'false' to
- * draw transparent.
+ * draw transparent. Ignored in XOR mode, the background is left as is.
  */
 void ssd1306_draw_bitmap(struct ssd1306_display *display, int16_t x0,
                          int16_t y0, const uint8_t *bitmap, uint16_t width,
@@ -1750,7 +5666,8 @@ void ssd1306_draw_bitmap(struct ssd1306_display *display, int16_t x0,
 
             if (!(pixels & 1)) {
                 ssd1306_draw_pixel(display, x0 + w, y0 + h);
-            } else if (has_bg) {
+            } else if (has_bg &&
+                       display->buffer_mode != SSD1306_BUFFER_MODE_XOR) {
                 ssd1306_set_buffer_mode_inverse(display);
                 ssd1306_draw_pixel(display, x0 + w, y0 + h);
                 ssd1306_set_buffer_mode_inverse(display);
@@ -1760,6 +5677,67 @@ void ssd1306_draw_bitmap(struct ssd1306_display *display, int16_t x0,
     }
 }
 
+/**
+ * @brief Draws a bitmap image in the native page-major layout of the display,
+ * starting from the specified coordinates and extending to the right and
+ * downward.
+ *
+ * @note
+ * - Every byte holds 8 rows of a column, top row in the LSB, the same as the
+ * display memory. Byte 'page * width + x' holds rows [page * 8...page * 8 + 7]
+ * of column 'x'. The unused bits of the last page are ignored.
+ *
+ * - Page-aligned images are copied as is, the others are shifted into place
+ * with two bytes per column. Much faster than ssd1306_draw_bitmap().
+ *
+ * - In transparent and opaque modes, draws the inverse of the image if the
+ * buffer is in clear mode. Invert mode ignores the buffer mode.
+ *
+ * - On a rotated display (see ssd1306_set_rotation()), the image is rotated
+ * along with the coordinates, 8x8 blocks at a time.
+ *
+ * - Drawing outside the border is allowed, but pixels that are out of bounds
+ * will be clipped.
+ *
+ * - Draw functions don't update the display. Don't forget to call the
+ * ssd1306_display_update() to push the buffer onto the display.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param x0 x-coordinate of the top left pixel of the image.
+ * @param y0 y-coordinate of the top left pixel of the image.
+ * @param bitmap Pointer to the bitmap array. MUST hold at least
+ * "width * ((height + 7) / 8)" bytes.
+ * @param width Width of the image in pixels.
+ * @param height Height of the image in pixels.
+ * @param mode Mode to draw the image with (see ssd1306_bitmap_mode).
+ */
+void ssd1306_draw_bitmap_native(struct ssd1306_display *display, int16_t x0,
+                                int16_t y0, const uint8_t *bitmap,
+                                uint16_t width, uint16_t height,
+                                enum ssd1306_bitmap_mode mode) {
+    int32_t x_min = x0;
+    int32_t x_max = (int32_t)x0 + width - 1;
+    int32_t y_min = y0;
+    int32_t y_max = (int32_t)y0 + height - 1;
+    if (x_min < display->border_x_min)
+        x_min = display->border_x_min;
+    if (x_max > display->border_x_max)
+        x_max = display->border_x_max;
+    if (y_min < display->border_y_min)
+        y_min = display->border_y_min;
+    if (y_max > display->border_y_max)
+        y_max = display->border_y_max;
+    if ((x_min > x_max) || (y_min > y_max))
+        return;
+
+    if (display->rotation != SSD1306_ROTATION_0)
+        h_draw_native_rotated(display, x0, y0, bitmap, width, height, mode,
+                              x_min, y_min, x_max, y_max);
+    else
+        h_draw_native(display, x0, y0, bitmap, width, height, mode, x_min,
+                      y_min, x_max, y_max);
+}
+
 /**
  * @brief Draws a character at the current cursor location.
  *
@@ -1811,7 +5789,7 @@ void ssd1306_draw_char(struct ssd1306_display *display, char c) {
     glyph = &display->font->glyph[c - display->font->first];
     h_draw_char(display, &display->font->bitmap[glyph->bitmap_offset],
                 glyph->width, glyph->height, glyph->x_offset, glyph->y_offset,
-                glyph->x_advance);
+                glyph->x_advance, true);
 }
 
 /**
@@ -1841,7 +5819,7 @@ void ssd1306_draw_char(struct ssd1306_display *display, char c) {
 void ssd1306_draw_char_custom(struct ssd1306_display *display,
                               const struct ssd1306_custom_char *c) {
     h_draw_char(display, c->bitmap, c->width, c->height, c->x_offset,
-                c->y_offset, c->x_advance);
+                c->y_offset, c->x_advance, false);
 }
 
 /**
@@ -2047,17 +6025,25 @@ void ssd1306_set_draw_border(struct ssd1306_display *display, uint8_t x_min,
     else
         SSD1306_Y_MAX = SSD1306_Y_MAX_32;
 
-    if (x_min > SSD1306_X_MAX)
-        x_min = SSD1306_X_MAX;
+    /* Portrait coordinates are the native ones swapped */
+    uint8_t x_last = SSD1306_X_MAX;
+    uint8_t y_last = SSD1306_Y_MAX;
+    if (h_is_portrait(display)) {
+        x_last = SSD1306_Y_MAX;
+        y_last = SSD1306_X_MAX;
+    }
+
+    if (x_min > x_last)
+        x_min = x_last;
 
-    if (x_max > SSD1306_X_MAX)
-        x_max = SSD1306_X_MAX;
+    if (x_max > x_last)
+        x_max = x_last;
 
-    if (y_min > SSD1306_Y_MAX)
-        y_min = SSD1306_Y_MAX;
+    if (y_min > y_last)
+        y_min = y_last;
 
-    if (y_max > SSD1306_Y_MAX)
-        y_max = SSD1306_Y_MAX;
+    if (y_max > y_last)
+        y_max = y_last;
 
     display->border_x_min = x_min;
     display->border_y_min = y_min;
@@ -2083,12 +6069,17 @@ void ssd1306_set_draw_border_reset(struct ssd1306_display *display) {
 
     display->border_x_min = 0;
     display->border_y_min = 0;
-    display->border_x_max = SSD1306_X_MAX;
-    display->border_y_max = SSD1306_Y_MAX;
+    if (h_is_portrait(display)) {
+        display->border_x_max = SSD1306_Y_MAX;
+        display->border_y_max = SSD1306_X_MAX;
+    } else {
+        display->border_x_max = SSD1306_X_MAX;
+        display->border_y_max = SSD1306_Y_MAX;
+    }
 }
 
 /**
- * @brief Sets the buffer mode of the display (draw/clear).
+ * @brief Sets the buffer mode of the display (draw/clear/XOR).
  *
  * @note
  * - In draw mode, all Draw Functions turn the pixels on as expected. In clear
@@ -2096,6 +6087,12 @@ void ssd1306_set_draw_border_reset(struct ssd1306_display *display) {
  * explanation, refer to
  * https://github.com/Microesque/SSD1306/wiki/Getting-Started#display-border.
  *
+ * - In XOR mode, the same functions toggle the pixels instead. Drawing the same
+ * shape twice restores the background, so moving objects can be erased
+ * without clearing and redrawing the whole buffer. Every pixel of a shape is
+ * toggled once. Images and characters toggle their set pixels only, and
+ * shifts treat XOR mode the same as draw mode.
+ *
  * @param display Pointer to the ssd1306_display structure.
  * @param mode Buffer mode to be set.
  */
@@ -2113,10 +6110,88 @@ void ssd1306_set_buffer_mode(struct ssd1306_display *display,
  * explanation, refer to
  * https://github.com/Microesque/SSD1306/wiki/Getting-Started#display-border.
  *
+ * - XOR mode is its own inverse, it's left as is.
+ *
  * @param display Pointer to the ssd1306_display structure.
  */
 void ssd1306_set_buffer_mode_inverse(struct ssd1306_display *display) {
-    display->buffer_mode ^= 1;
+    if (display->buffer_mode == SSD1306_BUFFER_MODE_DRAW)
+        display->buffer_mode = SSD1306_BUFFER_MODE_CLEAR;
+    else if (display->buffer_mode == SSD1306_BUFFER_MODE_CLEAR)
+        display->buffer_mode = SSD1306_BUFFER_MODE_DRAW;
+}
+
+/**
+ * @brief Sets the update mode of the display (full/dirty/diff).
+ *
+ * @note
+ * - In full mode, ssd1306_display_update() sends the entire buffer. In dirty
+ * mode, only the columns modified by the Draw Functions since the last update
+ * are sent, which saves bus time when little has changed.
+ *
+ * - In diff mode, the modified columns are also compared against a shadow copy
+ * of the display contents, so clearing and redrawing the same content costs
+ * nothing. Requires SSD1306_SHADOW_BUFFER to be enabled in the header file;
+ * otherwise diff mode behaves the same as dirty mode.
+ *
+ * - Modifications made directly through the pointer returned by
+ * sd1306_get_buffer() are not tracked. Use full mode if you do that.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param mode Update mode to be set.
+ */
+void ssd1306_set_update_mode(struct ssd1306_display *display,
+                             enum ssd1306_update_mode mode) {
+    display->update_mode = mode;
+}
+
+/**
+ * @brief Sets the transform mode of the display (full/border).
+ *
+ * @note
+ * - In full mode, ssd1306_draw_invert(), the mirror and the shift functions
+ * work on the entire buffer. In border mode, they only work on the pixels
+ * within the draw border, so a part of the screen can be scrolled or
+ * highlighted without touching the rest. The cost is proportional to the area
+ * of the border.
+ *
+ * - When shifting in border mode, pixels that shift past the border are
+ * clipped (or reappear on the opposite side if rotated), the pixels outside
+ * the border are never modified.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param mode Transform mode to be set.
+ */
+void ssd1306_set_transform_mode(struct ssd1306_display *display,
+                                enum ssd1306_transform_mode mode) {
+    display->transform_mode = mode;
+}
+
+/**
+ * @brief Sets the rotation of the drawing coordinates (0/90/180/270 degrees
+ * clockwise).
+ *
+ * @note
+ * - All the draw functions, the draw border and the cursor work in the rotated
+ * coordinates, so 90/270 degrees turn the screen into a portrait one
+ * (64x128 or 32x128). The buffer and the display stay as they are, the pixels
+ * are mapped onto them as they're drawn. Existing pixels aren't rotated.
+ *
+ * - Switching between landscape and portrait resets the draw border to cover
+ * the full screen, as the old one may be out of bounds.
+ *
+ * - A full-frame image can be drawn rotated with
+ * ssd1306_draw_bitmap_native(), using the size of the rotated screen.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param rotation Rotation to be set.
+ */
+void ssd1306_set_rotation(struct ssd1306_display *display,
+                          enum ssd1306_rotation rotation) {
+    bool was_portrait = h_is_portrait(display);
+    display->rotation = rotation;
+    if (h_is_portrait(display) != was_portrait)
+        ssd1306_set_draw_border_reset(display);
 }
 
 /**
@@ -2182,6 +6257,8 @@ void ssd1306_set_cursor(struct ssd1306_display *display, int16_t x, int16_t y) {
  * - If ssd1306_init() hasn't been called for the specified structure at least
  * once, the return value will be undefined.
  *
+ * - Returns 0 for the displays that are not connected via I2C.
+ *
  * @param display Pointer to the ssd1306_display structure.
  * @return The assigned 7-bit I2C address of the display.
  */
@@ -2189,6 +6266,20 @@ uint8_t ssd1306_get_display_address(struct ssd1306_display *display) {
     return (uint8_t)(display->i2c_address >> 1);
 }
 
+/**
+ * @brief Returns the context pointer of the display's custom transport.
+ *
+ * @note
+ * - The context can be set with the ssd1306_init_transport() function. Returns
+ * NULL for the displays initialized with ssd1306_init() or ssd1306_init_spi().
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @return The context pointer of the transport.
+ */
+void *ssd1306_get_transport_context(struct ssd1306_display *display) {
+    return display->transport_context;
+}
+
 /**
  * @brief Returns the assigned display type of the display (128x32 or 128x64).
  *
@@ -2232,7 +6323,7 @@ void ssd1306_get_draw_border(struct ssd1306_display *display, uint8_t *x_min,
 }
 
 /**
- * @brief Returns the current buffer mode of the display (draw/clear).
+ * @brief Returns the current buffer mode of the display (draw/clear/XOR).
  *
  * @note
  * - The buffer mode can be set with the ssd1306_set_buffer_mode() function.
@@ -2241,13 +6332,83 @@ void ssd1306_get_draw_border(struct ssd1306_display *display, uint8_t *x_min,
  * once, the return value will be undefined.
  *
  * @param display Pointer to the ssd1306_display structure.
- * @return The current buffer mode of the display (draw/clear).
+ * @return The current buffer mode of the display (draw/clear/XOR).
  */
 enum ssd1306_buffer_mode
 ssd1306_get_buffer_mode(struct ssd1306_display *display) {
     return display->buffer_mode;
 }
 
+/**
+ * @brief Returns the current update mode of the display (full/dirty/diff).
+ *
+ * @note
+ * - The update mode can be set with the ssd1306_set_update_mode() function.
+ *
+ * - If ssd1306_init() hasn't been called for the specified structure at least
+ * once, the return value will be undefined.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @return The current update mode of the display (full/dirty/diff).
+ */
+enum ssd1306_update_mode
+ssd1306_get_update_mode(struct ssd1306_display *display) {
+    return display->update_mode;
+}
+
+/**
+ * @brief Returns the current transform mode of the display (full/border).
+ *
+ * @note
+ * - The transform mode can be set with the ssd1306_set_transform_mode()
+ * function.
+ *
+ * - If ssd1306_init() hasn't been called for the specified structure at least
+ * once, the return value will be undefined.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @return The current transform mode of the display (full/border).
+ */
+enum ssd1306_transform_mode
+ssd1306_get_transform_mode(struct ssd1306_display *display) {
+    return display->transform_mode;
+}
+
+/**
+ * @brief Returns the current rotation of the drawing coordinates.
+ *
+ * @note
+ * - The rotation can be set with the ssd1306_set_rotation() function.
+ *
+ * - If ssd1306_init() hasn't been called for the specified structure at least
+ * once, the return value will be undefined.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @return The current rotation of the drawing coordinates.
+ */
+enum ssd1306_rotation ssd1306_get_rotation(struct ssd1306_display *display) {
+    return display->rotation;
+}
+
+/**
+ * @brief Returns the bus statistics of the last ssd1306_display_update() call.
+ *
+ * @note
+ * - Byte counts include the I2C address and control bytes of every
+ * transaction (none for SPI), and the commands needed to set up partial
+ * windows.
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param bytes_sent Pointer where the number of bytes sent will be placed.
+ * @param bytes_saved Pointer where the number of bytes saved compared to a full
+ * buffer update will be placed.
+ */
+void ssd1306_get_update_stats(struct ssd1306_display *display,
+                              uint16_t *bytes_sent, uint16_t *bytes_saved) {
+    *bytes_sent = display->update_bytes_sent;
+    *bytes_saved = display->update_bytes_saved;
+}
+
 /**
  * @brief Returns the current font assigned to the display.
  *
@@ -2309,6 +6470,9 @@ int16_t ssd1306_get_cursor(struct ssd1306_display *display, int16_t *x,
  * - If ssd1306_init() hasn't been called for the specified structure at least
  * once, the return value will be undefined.
  *
+ * - Direct writes to the buffer are not tracked by the dirty and diff update
+ * modes. Use full mode (ssd1306_set_update_mode()) if you write to it.
+ *
  * @param display Pointer to the ssd1306_display structure.
  * @return Pointer to the assigned display buffer.
  */
@@ -2332,6 +6496,8 @@ uint8_t ssd1306_get_buffer_pixel(struct ssd1306_display *display, int16_t x,
                                  int16_t y) {
     if (!h_are_coords_in_border(display, x, y))
         return 0;
+    if (display->rotation != SSD1306_ROTATION_0)
+        h_map_point(display, &x, &y);
 
     /* x > 0 and y > 0 after above check */
     uint16_t index = SSD1306_PAGE_OFFSETS[y >> 3] + (uint16_t)x;
@@ -51,6 +51,129 @@
  */
 #define SSD1306_PRINTF_CHAR_LIMIT 255
 
+/*
+ * The maximum number of vertices that ssd1306_draw_polygon_fill() can fill
+ * [3...255]. Polygons with more vertices are ignored.
+ *
+ * About "SSD1306_POLYGON_VERTEX_LIMIT * 41 + 142" bytes of stack will be used
+ * by the function while it runs (the edge table and the page band, 634 bytes
+ * with the default). 8-bit targets don't pad the structures, it's
+ * "SSD1306_POLYGON_VERTEX_LIMIT * 37 + 140" bytes for them. Lower the limit if
+ * the stack is small.
+ */
+#define SSD1306_POLYGON_VERTEX_LIMIT 12
+
+/*
+ * The number of columns that the outlines of ssd1306_draw_triangle() and
+ * ssd1306_draw_polygon() are drawn in at a time in XOR mode [1...128].
+ *
+ * "SSD1306_XOR_OUTLINE_CHUNK" bytes of stack will be used by the functions
+ * while they run in XOR mode (a copy of the chunk being drawn). Lower it if
+ * the stack is small. The lines are drawn again for every chunk of every page
+ * they cover, so smaller chunks are slower (about 2x with 32 for outlines
+ * that span the screen).
+ */
+#define SSD1306_XOR_OUTLINE_CHUNK 128
+
+/*
+ * The number of columns that the rotating vertical shifts
+ * (ssd1306_draw_shift_up() and ssd1306_draw_shift_down() and their "_by"
+ * variants with "is_rotated") work on at a time [1...128].
+ *
+ * "SSD1306_SHIFT_CHUNK * 8 + 64" bytes of stack will be used by the functions
+ * while they run (a copy of the chunk and the page tables, 192 bytes with the
+ * default, 320 bytes with 32). Lower it if the stack is small. Every chunk is
+ * a separate pass over the pages, so smaller chunks are slower (about 1.6x
+ * with 16 and 3x with 8 compared to 32 for a full-screen shift).
+ */
+#define SSD1306_SHIFT_CHUNK 16
+
+/*
+ * The number of circle profiles (row widths of a radius) that the filled
+ * circles, arcs and rounded rectangles keep cached, and the largest radius
+ * that uses a profile [1...255]. Larger radii calculate the widths per row.
+ * The cache is disabled when the number is 0 (default), the profile is then
+ * calculated on the stack for each shape. Enabling it saves that calculation
+ * when the same radii are drawn repeatedly.
+ *
+ * About "SSD1306_PROFILE_CACHE_SIZE * (SSD1306_PROFILE_RADIUS_MAX + 3)" bytes
+ * of memory will be reserved (statically for the functions, not per display).
+ *
+ * Either way, about "SSD1306_PROFILE_RADIUS_MAX + 143" bytes of stack will be
+ * used by the filled functions while they run (the profile and the page band,
+ * 175 bytes with the default). It's "SSD1306_PROFILE_RADIUS_MAX + 141" bytes
+ * on 8-bit targets, which don't pad the structures.
+ */
+#define SSD1306_PROFILE_CACHE_SIZE 0
+#define SSD1306_PROFILE_RADIUS_MAX 32
+
+/*
+ * The number of font glyphs that are kept cached in the native page-major
+ * layout of the display, and the size of each cache slot in bytes. Glyphs
+ * that need more bytes than a slot ("width * ((height + 7) / 8)") aren't
+ * cached. The least recently used glyph is replaced when the cache is full.
+ * The cache is disabled when the number is 0 (default).
+ *
+ * About "SSD1306_GLYPH_CACHE_COUNT * (SSD1306_GLYPH_CACHE_SLOT_SIZE + 8)"
+ * bytes of memory will be reserved (statically for the functions, not per
+ * display).
+ *
+ * Glyphs that aren't cached but fit in a slot are converted on the stack for
+ * every character instead, so "SSD1306_GLYPH_CACHE_SLOT_SIZE" bytes of stack
+ * will be used while drawing text even when the cache is disabled. The cache
+ * only saves the conversion, which is a small part of drawing a glyph.
+ */
+#define SSD1306_GLYPH_CACHE_COUNT 0
+#define SSD1306_GLYPH_CACHE_SLOT_SIZE 32
+
+/*
+ * Keep a shadow copy of what the display memory currently holds, so that
+ * ssd1306_display_update() in diff mode only sends the bytes that actually
+ * changed [true | false].
+ *
+ * Doubles the buffer size of each display (the SSD1306_ARRAY_SIZE_XX macros
+ * account for it automatically).
+ */
+#define SSD1306_SHADOW_BUFFER false
+
+/*
+ * Use SSE2/NEON instructions for the whole-buffer operations (clear, fill,
+ * invert, etc.) when the compiler targets them [true | false].
+ *
+ * The results are the same either way. Other targets always use 32-bit words.
+ */
+#define SSD1306_SIMD true
+
+/*
+ * Use asynchronous (DMA/interrupt driven) transfers [true | false].
+ *
+ * When enabled, the i2c_write callback must only start the transfer and return
+ * immediately. Once the transfer is complete, ssd1306_transfer_complete() must
+ * be called (typically from the DMA/I2C interrupt handler). Frames are copied
+ * to a separate transmit buffer, so drawing can continue while the previous
+ * frame is being sent.
+ *
+ * Adds a transmit buffer to each display (the SSD1306_ARRAY_SIZE_XX macros
+ * account for it automatically). If SSD1306_SHADOW_BUFFER is also enabled, the
+ * transmit buffer doubles as the shadow buffer at no extra cost.
+ */
+#define SSD1306_ASYNC_TRANSFER false
+
+/*
+ * The maximum number of windows an update can be split into [8...255]. Each
+ * window takes 4 bytes of memory per display. If an update needs more windows,
+ * the last window grows to cover the rest.
+ */
+#define SSD1306_WINDOW_LIMIT 16
+
+/*
+ * The maximum number of command bytes that can be batched into a single
+ * transaction [8...253]. Takes this many bytes of memory per display. A batch
+ * is sent early once less than 8 bytes remain (the longest command), so
+ * ssd1306_reinit() needs at least 35 to send all of its commands at once.
+ */
+#define SSD1306_CMD_BATCH_LIMIT 36
+
 /*
  * The following define the default values or actions taken after a display
  * init/reinit. Square brackets indicate the valid range of values.
@@ -107,10 +230,35 @@
 
 /*
  * The default buffer mode
- * [SSD1306_BUFFER_MODE_CLEAR | SSD1306_BUFFER_MODE_DRAW].
+ * [SSD1306_BUFFER_MODE_CLEAR | SSD1306_BUFFER_MODE_DRAW |
+ * SSD1306_BUFFER_MODE_XOR].
  */
 #define SSD1306_DEFAULT_BUFFER_MODE SSD1306_BUFFER_MODE_DRAW
 
+/*
+ * The default update mode
+ * [SSD1306_UPDATE_MODE_FULL | SSD1306_UPDATE_MODE_DIRTY |
+ * SSD1306_UPDATE_MODE_DIFF].
+ * Dirty and diff modes don't see direct writes to the display buffer.
+ */
+#define SSD1306_DEFAULT_UPDATE_MODE SSD1306_UPDATE_MODE_FULL
+
+/*
+ * The default transform mode
+ * [SSD1306_TRANSFORM_MODE_FULL | SSD1306_TRANSFORM_MODE_BORDER].
+ */
+#define SSD1306_DEFAULT_TRANSFORM_MODE SSD1306_TRANSFORM_MODE_FULL
+
+/*
+ * The default rotation of the drawing coordinates
+ * [SSD1306_ROTATION_0 | SSD1306_ROTATION_90 | SSD1306_ROTATION_180 |
+ * SSD1306_ROTATION_270].
+ *
+ * With 90 or 270, the default draw border above is ignored and the border
+ * covers the entire (portrait) screen.
+ */
+#define SSD1306_DEFAULT_ROTATION SSD1306_ROTATION_0
+
 /*
  * Clear the buffer [true | false].
  */
@@ -151,11 +299,71 @@
 /*
  * Buffer modes for the displays. In draw mode, draw functions will turn the
  * pixels on. In clear mode, draw functions will turn the pixels off
- * instead.
+ * instead. In XOR mode, draw functions will toggle the pixels, so drawing the
+ * same thing twice restores the background.
  */
 enum ssd1306_buffer_mode {
     SSD1306_BUFFER_MODE_CLEAR, /* Buffer mode 'clear' */
-    SSD1306_BUFFER_MODE_DRAW   /* Buffer mode 'draw' */
+    SSD1306_BUFFER_MODE_DRAW,  /* Buffer mode 'draw' */
+    SSD1306_BUFFER_MODE_XOR    /* Buffer mode 'xor' */
+};
+
+/*
+ * Update modes for the displays. In full mode, ssd1306_display_update() sends
+ * the entire buffer. In dirty mode, only the columns modified by the draw
+ * functions since the last update are sent. In diff mode, the modified columns
+ * are also compared against the shadow buffer, and only the bytes that changed
+ * are sent (requires SSD1306_SHADOW_BUFFER, otherwise same as dirty mode).
+ */
+enum ssd1306_update_mode {
+    SSD1306_UPDATE_MODE_FULL,  /* Update mode 'full' */
+    SSD1306_UPDATE_MODE_DIRTY, /* Update mode 'dirty' */
+    SSD1306_UPDATE_MODE_DIFF   /* Update mode 'diff' */
+};
+
+/*
+ * Transform modes for the displays. In full mode, the buffer transforms
+ * (invert/mirror/shift) work on the entire buffer. In border mode, they only
+ * work on the pixels within the draw border, leaving the rest untouched.
+ */
+enum ssd1306_transform_mode {
+    SSD1306_TRANSFORM_MODE_FULL,  /* Transform mode 'full' */
+    SSD1306_TRANSFORM_MODE_BORDER /* Transform mode 'border' */
+};
+
+/*
+ * Rotations of the drawing coordinates, clockwise. With 90 and 270, the screen
+ * is in portrait (32x128 or 64x128). All draw functions, the draw border and
+ * the cursor use the rotated coordinates. The buffer itself always keeps the
+ * native layout of the display.
+ */
+enum ssd1306_rotation {
+    SSD1306_ROTATION_0,   /* Rotation '0' (native landscape) */
+    SSD1306_ROTATION_90,  /* Rotation '90' (portrait) */
+    SSD1306_ROTATION_180, /* Rotation '180' (upside-down landscape) */
+    SSD1306_ROTATION_270  /* Rotation '270' (upside-down portrait) */
+};
+
+/*
+ * Fill rules for ssd1306_draw_polygon_fill(), they decide which parts of a
+ * self-intersecting polygon are inside. With even-odd, areas enclosed an odd
+ * number of times are filled. With non-zero, all enclosed areas are filled.
+ */
+enum ssd1306_fill_rule {
+    SSD1306_FILL_RULE_EVEN_ODD, /* Fill rule 'even-odd' */
+    SSD1306_FILL_RULE_NON_ZERO  /* Fill rule 'non-zero' */
+};
+
+/*
+ * Modes for ssd1306_draw_bitmap_native(). In transparent mode, only the set
+ * bits of the bitmap are drawn. In opaque mode, the cleared bits overwrite
+ * the background as well. In invert mode, the pixels under the set bits are
+ * inverted.
+ */
+enum ssd1306_bitmap_mode {
+    SSD1306_BITMAP_MODE_TRANSPARENT, /* Bitmap mode 'transparent' */
+    SSD1306_BITMAP_MODE_OPAQUE,      /* Bitmap mode 'opaque' */
+    SSD1306_BITMAP_MODE_INVERT       /* Bitmap mode 'invert' */
 };
 
 /*
@@ -169,8 +377,16 @@ enum ssd1306_display_type {
 /*
  * Buffer sizes required for the respective display types.
  */
+#if SSD1306_ASYNC_TRANSFER == true
+#define SSD1306_ARRAY_SIZE_32 (2 + 512 + 2 + 512)   /* For 128x32 displays */
+#define SSD1306_ARRAY_SIZE_64 (2 + 1024 + 2 + 1024) /* For 128x64 displays */
+#elif SSD1306_SHADOW_BUFFER == true
+#define SSD1306_ARRAY_SIZE_32 (2 + 512 + 512)   /* For 128x32 displays */
+#define SSD1306_ARRAY_SIZE_64 (2 + 1024 + 1024) /* For 128x64 displays */
+#else
 #define SSD1306_ARRAY_SIZE_32 (2 + 512)  /* For 128x32 displays */
 #define SSD1306_ARRAY_SIZE_64 (2 + 1024) /* For 128x64 displays */
+#endif
 
 /*
  * Maximum coordinates for the respective display types (128x32 and 128x64).
@@ -230,19 +446,91 @@ struct ssd1306_custom_char {
 };
 
 /*
- * Structure presenting displays. Initialize with ssd1306_init().
+ * Structure representing a column/page window of the display memory.
+ */
+struct ssd1306_window {
+    uint8_t x_min;
+    uint8_t x_max;
+    uint8_t page_min;
+    uint8_t page_max;
+};
+
+struct ssd1306_display;
+
+/*
+ * Structure representing the bus operations of displays. Use the provided
+ * ssd1306_transport_i2c/ssd1306_transport_spi, or a custom one with
+ * ssd1306_init_transport().
+ *
+ * The two bytes before the cmd/data pointers are free to be overwritten (for a
+ * header), they're restored by the library. The overhead is the number of bus
+ * bytes each transaction takes in addition to the cmd/data bytes.
+ */
+struct ssd1306_transport {
+    void (*write_cmd)(struct ssd1306_display *display, uint8_t *cmd,
+                      uint16_t length);
+    void (*write_data)(struct ssd1306_display *display, uint8_t *data,
+                       uint16_t length);
+    uint8_t overhead;
+};
+
+/*
+ * Structure presenting displays. Initialize with ssd1306_init(),
+ * ssd1306_init_spi() or ssd1306_init_transport().
  */
 struct ssd1306_display {
+    const struct ssd1306_transport *transport;
+    void *transport_context;
     void (*i2c_write)(uint8_t *data, uint16_t length);
+    void (*spi_write)(uint8_t *data, uint16_t length);
+    void (*spi_dc_write)(bool is_data);
     const struct ssd1306_font *font;
     uint8_t *data_buffer;
+    uint8_t *tx_buffer;
     uint8_t *cmd_buffer;
+#if SSD1306_SHADOW_BUFFER == true
+    uint8_t *shadow_buffer;
+    bool is_shadow_valid;
+#endif
     int16_t cursor_x0;
     int16_t cursor_x;
     int16_t cursor_y;
     enum ssd1306_display_type display_type;
     enum ssd1306_buffer_mode buffer_mode;
-    uint8_t cmd_memory[10];
+    enum ssd1306_update_mode update_mode;
+    enum ssd1306_transform_mode transform_mode;
+    enum ssd1306_rotation rotation;
+    uint16_t update_bytes_sent;
+    uint16_t update_bytes_saved;
+    uint8_t dirty_x_min[8];
+    uint8_t dirty_x_max[8];
+    bool is_window_full;
+    struct ssd1306_window windows[SSD1306_WINDOW_LIMIT];
+    uint16_t window_offset;
+    uint16_t transfer_limit;
+    uint16_t span_index;
+    uint16_t span_length;
+    uint8_t span_header[2];
+    uint8_t window_count;
+    uint8_t window_index;
+    uint8_t window_page;
+    uint8_t window_memory[8];
+#if SSD1306_ASYNC_TRANSFER == true
+    volatile bool is_busy;
+    bool is_step_update;
+#endif
+    uint8_t cmd_memory[2 + SSD1306_CMD_BATCH_LIMIT];
+    uint8_t cmd_batch_length;
+    bool is_cmd_batch;
+    bool is_update_pending;
+    bool is_reg_valid;
+    bool is_reg_enabled;
+    bool is_reg_fully_on;
+    bool is_reg_inverse;
+    bool is_reg_mirror_h;
+    bool is_reg_mirror_v;
+    bool is_reg_scrolling;
+    uint8_t reg_brightness;
     uint8_t i2c_address;
     uint8_t font_scale;
     uint8_t border_x_min;
@@ -251,6 +539,13 @@ struct ssd1306_display {
     uint8_t border_y_max;
 };
 
+/*----------------------------------------------------------------------------*/
+/*---------------------------- Available Transports --------------------------*/
+/*----------------------------------------------------------------------------*/
+
+extern const struct ssd1306_transport ssd1306_transport_i2c;
+extern const struct ssd1306_transport ssd1306_transport_spi;
+
 /*----------------------------------------------------------------------------*/
 /*---------------------------- Available Functions ---------------------------*/
 /*----------------------------------------------------------------------------*/
@@ -258,9 +553,25 @@ struct ssd1306_display {
 void ssd1306_init(struct ssd1306_display *display, uint8_t i2c_address,
                   enum ssd1306_display_type display_type, uint8_t *array,
                   void (*i2c_write)(uint8_t *data, uint16_t length));
+void ssd1306_init_spi(struct ssd1306_display *display,
+                      enum ssd1306_display_type display_type, uint8_t *array,
+                      void (*spi_write)(uint8_t *data, uint16_t length),
+                      void (*spi_dc_write)(bool is_data));
+void ssd1306_init_transport(struct ssd1306_display *display,
+                            enum ssd1306_display_type display_type,
+                            uint8_t *array,
+                            const struct ssd1306_transport *transport,
+                            void *context);
 void ssd1306_reinit(struct ssd1306_display *display);
+void ssd1306_display_resync(struct ssd1306_display *display);
 
 void ssd1306_display_update(struct ssd1306_display *display);
+bool ssd1306_display_update_step(struct ssd1306_display *display,
+                                 uint16_t max_bytes);
+bool ssd1306_display_is_busy(struct ssd1306_display *display);
+void ssd1306_transfer_complete(struct ssd1306_display *display);
+void ssd1306_display_batch_begin(struct ssd1306_display *display);
+void ssd1306_display_batch_end(struct ssd1306_display *display);
 void ssd1306_display_brightness(struct ssd1306_display *display,
                                 uint8_t brightness);
 void ssd1306_display_enable(struct ssd1306_display *display, bool is_enabled);
@@ -282,6 +593,14 @@ void ssd1306_draw_shift_right(struct ssd1306_display *display, bool is_rotated);
 void ssd1306_draw_shift_left(struct ssd1306_display *display, bool is_rotated);
 void ssd1306_draw_shift_up(struct ssd1306_display *display, bool is_rotated);
 void ssd1306_draw_shift_down(struct ssd1306_display *display, bool is_rotated);
+void ssd1306_draw_shift_right_by(struct ssd1306_display *display, uint8_t count,
+                                 bool is_rotated);
+void ssd1306_draw_shift_left_by(struct ssd1306_display *display, uint8_t count,
+                                bool is_rotated);
+void ssd1306_draw_shift_up_by(struct ssd1306_display *display, uint8_t count,
+                              bool is_rotated);
+void ssd1306_draw_shift_down_by(struct ssd1306_display *display, uint8_t count,
+                                bool is_rotated);
 void ssd1306_draw_pixel(struct ssd1306_display *display, int16_t x, int16_t y);
 void ssd1306_draw_line_h(struct ssd1306_display *display, int16_t x0,
                          int16_t y0, int16_t width);
@@ -295,6 +614,11 @@ void ssd1306_draw_triangle(struct ssd1306_display *display, int16_t x0,
 void ssd1306_draw_triangle_fill(struct ssd1306_display *display, int16_t x0,
                                 int16_t y0, int16_t x1, int16_t y1, int16_t x2,
                                 int16_t y2);
+void ssd1306_draw_polygon(struct ssd1306_display *display,
+                          const int16_t *points, uint8_t count);
+void ssd1306_draw_polygon_fill(struct ssd1306_display *display,
+                               const int16_t *points, uint8_t count,
+                               enum ssd1306_fill_rule rule);
 void ssd1306_draw_rect(struct ssd1306_display *display, int16_t x0, int16_t y0,
                        int16_t width, int16_t height);
 void ssd1306_draw_rect_fill(struct ssd1306_display *display, int16_t x0,
@@ -316,6 +640,10 @@ void ssd1306_draw_circle_fill(struct ssd1306_display *display, int16_t x0,
 void ssd1306_draw_bitmap(struct ssd1306_display *display, int16_t x0,
                          int16_t y0, const uint8_t *bitmap, uint16_t width,
                          uint16_t height, bool has_bg);
+void ssd1306_draw_bitmap_native(struct ssd1306_display *display, int16_t x0,
+                                int16_t y0, const uint8_t *bitmap,
+                                uint16_t width, uint16_t height,
+                                enum ssd1306_bitmap_mode mode);
 void ssd1306_draw_char(struct ssd1306_display *display, char c);
 void ssd1306_draw_char_custom(struct ssd1306_display *display,
                               const struct ssd1306_custom_char *c);
@@ -332,18 +660,32 @@ void ssd1306_set_draw_border_reset(struct ssd1306_display *display);
 void ssd1306_set_buffer_mode(struct ssd1306_display *display,
                              enum ssd1306_buffer_mode mode);
 void ssd1306_set_buffer_mode_inverse(struct ssd1306_display *display);
+void ssd1306_set_update_mode(struct ssd1306_display *display,
+                             enum ssd1306_update_mode mode);
+void ssd1306_set_transform_mode(struct ssd1306_display *display,
+                                enum ssd1306_transform_mode mode);
+void ssd1306_set_rotation(struct ssd1306_display *display,
+                          enum ssd1306_rotation rotation);
 void ssd1306_set_font(struct ssd1306_display *display,
                       const struct ssd1306_font *font);
 void ssd1306_set_font_scale(struct ssd1306_display *display, uint8_t scale);
 void ssd1306_set_cursor(struct ssd1306_display *display, int16_t x, int16_t y);
 
 uint8_t ssd1306_get_display_address(struct ssd1306_display *display);
+void *ssd1306_get_transport_context(struct ssd1306_display *display);
 enum ssd1306_display_type
 ssd1306_get_display_type(struct ssd1306_display *display);
 void ssd1306_get_draw_border(struct ssd1306_display *display, uint8_t *x_min,
                              uint8_t *y_min, uint8_t *x_max, uint8_t *y_max);
 enum ssd1306_buffer_mode
 ssd1306_get_buffer_mode(struct ssd1306_display *display);
+enum ssd1306_update_mode
+ssd1306_get_update_mode(struct ssd1306_display *display);
+enum ssd1306_transform_mode
+ssd1306_get_transform_mode(struct ssd1306_display *display);
+enum ssd1306_rotation ssd1306_get_rotation(struct ssd1306_display *display);
+void ssd1306_get_update_stats(struct ssd1306_display *display,
+                              uint16_t *bytes_sent, uint16_t *bytes_saved);
 const struct ssd1306_font *ssd1306_get_font(struct ssd1306_display *display);
 uint8_t ssd1306_get_font_scale(struct ssd1306_display *display);
 int16_t ssd1306_get_cursor(struct ssd1306_display *display, int16_t *x,
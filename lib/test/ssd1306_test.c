@@ -104,6 +104,8 @@ static void h_draw_logo(struct ssd1306_display *display) {
  *
  * - ssd1306_reinit()
  *
+ * - ssd1306_display_resync()
+ *
  * @param display Pointer to the ssd1306_display structure.
  * @param delay Arbitrary delay value that slows down the animation.
  * Recommended starting value is 6000.
@@ -115,6 +117,12 @@ void ssd1306_test_reinit(struct ssd1306_display *display, uint16_t delay) {
 
         ssd1306_reinit(display);
         h_delay(delay);
+
+        h_draw_logo(display);
+        ssd1306_display_inverse(display, true);
+        ssd1306_display_resync(display);
+        h_delay(delay);
+        ssd1306_display_inverse(display, false);
     }
 }
 
@@ -263,6 +271,39 @@ void ssd1306_test_scroll_enable_disable(struct ssd1306_display *display,
     }
 }
 
+/**
+ * @brief Tests for:
+ *
+ * - ssd1306_display_batch_begin()
+ *
+ * - ssd1306_display_batch_end()
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param delay Arbitrary delay value that slows down the animation. Recommended
+ * starting value is 6000.
+ */
+void ssd1306_test_batch(struct ssd1306_display *display, uint16_t delay) {
+    h_draw_logo(display);
+
+    while (1) {
+        ssd1306_display_batch_begin(display);
+        ssd1306_display_brightness(display, 255);
+        ssd1306_display_inverse(display, true);
+        ssd1306_display_mirror_h(display, true);
+        ssd1306_display_mirror_v(display, true);
+        ssd1306_display_batch_end(display);
+        h_delay(delay);
+
+        ssd1306_display_batch_begin(display);
+        ssd1306_display_brightness(display, 0);
+        ssd1306_display_inverse(display, false);
+        ssd1306_display_mirror_h(display, false);
+        ssd1306_display_mirror_v(display, false);
+        ssd1306_display_batch_end(display);
+        h_delay(delay);
+    }
+}
+
 /**
  * @brief Tests for:
  *
@@ -499,6 +540,79 @@ void ssd1306_test_draw_triangles(struct ssd1306_display *display,
     }
 }
 
+/**
+ * @brief Tests for:
+ *
+ * - ssd1306_draw_polygon()
+ *
+ * - ssd1306_draw_polygon_fill()
+ *
+ * @note
+ * - Moves a five-pointed star back and forth, cycling through the outline,
+ * even-odd fill (hollow center) and non-zero fill (solid center).
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param delay Arbitrary delay value that slows down the animation. Recommended
+ * starting value is 0.
+ */
+void ssd1306_test_draw_polygons(struct ssd1306_display *display,
+                                uint16_t delay) {
+    enum direction {
+        NEGATIVE,
+        POSITIVE
+    };
+    enum style {
+        OUTLINE,
+        EVEN_ODD,
+        NON_ZERO
+    };
+
+    /* Points of the star, relative to its center (for a radius of 100) */
+    static const int8_t star[10] = {0,   -100, 59, 81, -95,
+                                    -31, 95,   -31, -59, 81};
+
+    int16_t r;
+    if (display->display_type)
+        r = SSD1306_Y_MAX_64 >> 1;
+    else
+        r = SSD1306_Y_MAX_32 >> 1;
+
+    int16_t points[10];
+    int16_t x = r;
+    enum style style = OUTLINE;
+    enum direction dir = POSITIVE;
+    while (1) {
+        if (dir == POSITIVE)
+            x++;
+        else
+            x--;
+
+        if (x == r) {
+            dir = POSITIVE;
+        } else if (x == SSD1306_X_MAX - r) {
+            dir = NEGATIVE;
+            style = (style == NON_ZERO) ? OUTLINE : style + 1;
+        }
+
+        for (uint8_t i = 0; i < 10; i += 2) {
+            points[i] = x + (star[i] * r) / 100;
+            points[i + 1] = r + (star[i + 1] * r) / 100;
+        }
+
+        ssd1306_draw_clear(display);
+        if (style == OUTLINE)
+            ssd1306_draw_polygon(display, points, 5);
+        else if (style == EVEN_ODD)
+            ssd1306_draw_polygon_fill(display, points, 5,
+                                      SSD1306_FILL_RULE_EVEN_ODD);
+        else
+            ssd1306_draw_polygon_fill(display, points, 5,
+                                      SSD1306_FILL_RULE_NON_ZERO);
+        ssd1306_display_update(display);
+        h_delay(delay);
+    }
+}
+
 /**
  * @brief Tests for:
  *
@@ -866,6 +980,99 @@ void ssd1306_test_buffer_mode(struct ssd1306_display *display, uint16_t delay) {
     }
 }
 
+/**
+ * @brief Tests for:
+ *
+ * - ssd1306_set_buffer_mode() (XOR mode)
+ *
+ * - ssd1306_set_buffer_mode_inverse() (XOR mode)
+ *
+ * - ssd1306_get_buffer_mode() (XOR mode)
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param delay Arbitrary delay value that slows down the animation. Recommended
+ * starting value is 6000.
+ */
+void ssd1306_test_buffer_mode_xor(struct ssd1306_display *display,
+                                  uint16_t delay) {
+    /* Tests */
+    while (1) {
+        ssd1306_set_buffer_mode(display, SSD1306_BUFFER_MODE_XOR);
+        if (ssd1306_get_buffer_mode(display) == SSD1306_BUFFER_MODE_XOR)
+            break;
+    }
+    ssd1306_set_buffer_mode_inverse(display);
+    while (1) {
+        if (ssd1306_get_buffer_mode(display) == SSD1306_BUFFER_MODE_XOR)
+            break;
+    }
+
+    /* Animation, the circle is erased by drawing it again */
+    ssd1306_set_buffer_mode(display, SSD1306_BUFFER_MODE_DRAW);
+    ssd1306_draw_clear(display);
+    ssd1306_draw_rect_fill(display, 0, 0, SSD1306_X_MAX / 2, SSD1306_Y_MAX_64);
+    ssd1306_set_buffer_mode(display, SSD1306_BUFFER_MODE_XOR);
+    while (1) {
+        for (int16_t x = 0; x <= SSD1306_X_MAX; x++) {
+            ssd1306_draw_circle_fill(display, x, 16, 10);
+            ssd1306_display_update(display);
+            h_delay(delay);
+            ssd1306_draw_circle_fill(display, x, 16, 10);
+        }
+    }
+}
+
+/**
+ * @brief Tests for (requires font to be set up, ideally < 10px):
+ *
+ * - ssd1306_set_rotation()
+ *
+ * - ssd1306_get_rotation()
+ *
+ * @param display Pointer to the ssd1306_display structure.
+ * @param delay Arbitrary delay value that slows down the animation. Recommended
+ * starting value is 6000.
+ */
+void ssd1306_test_rotation(struct ssd1306_display *display, uint16_t delay) {
+    uint8_t x_min, y_min, x_max, y_max;
+
+    /* Tests */
+    ssd1306_set_rotation(display, SSD1306_ROTATION_90);
+    ssd1306_get_draw_border(display, &x_min, &y_min, &x_max, &y_max);
+    while (1) {
+        if ((ssd1306_get_rotation(display) == SSD1306_ROTATION_90) &&
+            (x_max < y_max) && (y_max == SSD1306_X_MAX))
+            break;
+    }
+
+    ssd1306_set_rotation(display, SSD1306_ROTATION_0);
+    ssd1306_get_draw_border(display, &x_min, &y_min, &x_max, &y_max);
+    while (1) {
+        if ((ssd1306_get_rotation(display) == SSD1306_ROTATION_0) &&
+            (x_max == SSD1306_X_MAX))
+            break;
+    }
+
+    /* Animation */
+    enum ssd1306_rotation rotation = SSD1306_ROTATION_0;
+    while (1) {
+        if (rotation == SSD1306_ROTATION_270)
+            rotation = SSD1306_ROTATION_0;
+        else
+            rotation++;
+
+        ssd1306_draw_clear(display);
+        ssd1306_set_rotation(display, rotation);
+        ssd1306_get_draw_border(display, &x_min, &y_min, &x_max, &y_max);
+        ssd1306_draw_rect(display, 0, 0, x_max + 1, y_max + 1);
+        ssd1306_draw_triangle_fill(display, 2, 2, 12, 2, 2, 12);
+        ssd1306_set_cursor(display, 16, 16);
+        ssd1306_draw_str(display, "TOP");
+        ssd1306_display_update(display);
+        h_delay(delay);
+    }
+}
+
 /**
  * @brief Tests for (requires font to be set up, ideally < 10px):
  *
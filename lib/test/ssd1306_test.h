@@ -48,6 +48,7 @@ void ssd1306_test_inverse(struct ssd1306_display *display, uint16_t delay);
 void ssd1306_test_mirrors(struct ssd1306_display *display, uint16_t delay);
 void ssd1306_test_scroll_enable_disable(struct ssd1306_display *display,
                                         uint16_t delay);
+void ssd1306_test_batch(struct ssd1306_display *display, uint16_t delay);
 
 void ssd1306_test_draw_clear_fill(struct ssd1306_display *display,
                                   uint16_t delay);
@@ -57,6 +58,8 @@ void ssd1306_test_draw_shifts(struct ssd1306_display *display, uint16_t delay);
 void ssd1306_test_draw_lines(struct ssd1306_display *display, uint16_t delay);
 void ssd1306_test_draw_triangles(struct ssd1306_display *display,
                                  uint16_t delay);
+void ssd1306_test_draw_polygons(struct ssd1306_display *display,
+                                uint16_t delay);
 void ssd1306_test_draw_rects(struct ssd1306_display *display, uint16_t delay);
 void ssd1306_test_draw_rect_rounds(struct ssd1306_display *display,
                                    uint16_t delay);
@@ -65,6 +68,9 @@ void ssd1306_test_draw_chars(struct ssd1306_display *display, uint16_t delay);
 
 void ssd1306_test_border(struct ssd1306_display *display, uint16_t delay);
 void ssd1306_test_buffer_mode(struct ssd1306_display *display, uint16_t delay);
+void ssd1306_test_buffer_mode_xor(struct ssd1306_display *display,
+                                  uint16_t delay);
+void ssd1306_test_rotation(struct ssd1306_display *display, uint16_t delay);
 void ssd1306_test_font(struct ssd1306_display *display, uint16_t delay);
 void ssd1306_test_get_others(struct ssd1306_display *display, uint16_t delay);
 